@@ -0,0 +1,74 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FREE_FDB_BACKEND_MEMORY_ERROR_HH
+#define FREE_FDB_BACKEND_MEMORY_ERROR_HH
+
+#define FDB_API_VERSION 610
+#include <foundationdb/fdb_c.h>
+
+/**
+ * Subset of the FoundationDB error codes the in-memory backend can return.
+ * @see https://apple.github.io/foundationdb/api-error-codes.html
+ */
+namespace ffdb::memory::error {
+
+constexpr fdb_error_t success = 0;
+constexpr fdb_error_t transaction_too_old = 1007;
+constexpr fdb_error_t future_version = 1009;
+constexpr fdb_error_t not_committed = 1020;
+constexpr fdb_error_t commit_unknown_result = 1021;
+constexpr fdb_error_t transaction_cancelled = 1025;
+constexpr fdb_error_t transaction_timed_out = 1031;
+constexpr fdb_error_t too_many_watches = 1032;
+constexpr fdb_error_t accessed_unreadable = 1036;
+constexpr fdb_error_t process_behind = 1037;
+constexpr fdb_error_t operation_cancelled = 1101;
+constexpr fdb_error_t client_invalid_operation = 2000;
+constexpr fdb_error_t key_outside_legal_range = 2004;
+constexpr fdb_error_t inverted_range = 2005;
+constexpr fdb_error_t invalid_option_value = 2006;
+constexpr fdb_error_t invalid_option = 2007;
+constexpr fdb_error_t network_not_setup = 2008;
+constexpr fdb_error_t network_already_setup = 2009;
+constexpr fdb_error_t no_commit_version = 2021;
+constexpr fdb_error_t transaction_too_large = 2101;
+constexpr fdb_error_t key_too_large = 2102;
+constexpr fdb_error_t value_too_large = 2103;
+constexpr fdb_error_t api_version_unset = 2200;
+constexpr fdb_error_t api_version_already_set = 2201;
+constexpr fdb_error_t api_version_not_supported = 2203;
+
+[[nodiscard]] constexpr bool is_maybe_committed(fdb_error_t code) {
+  return code == commit_unknown_result;
+}
+
+[[nodiscard]] constexpr bool is_retryable(fdb_error_t code) {
+  return code == transaction_too_old || code == future_version || code == not_committed
+	  || code == process_behind || is_maybe_committed(code);
+}
+
+}// namespace ffdb::memory::error
+
+#endif//FREE_FDB_BACKEND_MEMORY_ERROR_HH
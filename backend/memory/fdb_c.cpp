@@ -0,0 +1,393 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <cstring>
+#include <mutex>
+
+#include "error.hh"
+#include "future.hh"
+#include "store.hh"
+#include "transaction.hh"
+
+using namespace ffdb::memory;
+
+struct FDB_database {
+  std::shared_ptr<store> data;
+
+  //! options given to every transaction created from the database
+  transaction_options transaction_defaults{};
+  int max_watches = default_max_watches;
+};
+
+namespace {
+
+std::string_view to_view(const std::uint8_t *data, int length) {
+  return std::string_view(reinterpret_cast<const char *>(data), std::size_t(length));
+}
+
+fdb_error_t int_option(const std::uint8_t *value, int length, std::int64_t &out) {
+  if (!value || length != sizeof(std::int64_t)) {
+	return error::invalid_option_value;
+  }
+  std::memcpy(&out, value, sizeof(std::int64_t));
+  return error::success;
+}
+
+int selected_api_version = 0;
+
+}// namespace
+
+extern "C" {
+
+const char *fdb_get_error(fdb_error_t code) {
+  switch (code) {
+	case error::success:
+	  return "Success";
+	case error::transaction_too_old:
+	  return "Transaction is too old to perform reads or be committed";
+	case error::future_version:
+	  return "Request for future version";
+	case error::not_committed:
+	  return "Transaction not committed due to conflict with another transaction";
+	case error::commit_unknown_result:
+	  return "Transaction may or may not have committed";
+	case error::transaction_cancelled:
+	  return "Operation aborted because the transaction was cancelled";
+	case error::transaction_timed_out:
+	  return "Operation aborted because the transaction timed out";
+	case error::too_many_watches:
+	  return "Too many watches currently set";
+	case error::accessed_unreadable:
+	  return "Read or wrote an unreadable key";
+	case error::process_behind:
+	  return "Storage process does not have recent mutations";
+	case error::operation_cancelled:
+	  return "Asynchronous operation cancelled";
+	case error::client_invalid_operation:
+	  return "Invalid API call";
+	case error::key_outside_legal_range:
+	  return "Key outside legal range";
+	case error::inverted_range:
+	  return "Range begin key larger than end key";
+	case error::invalid_option_value:
+	  return "Option set with an invalid value";
+	case error::invalid_option:
+	  return "Option not valid in this context";
+	case error::network_not_setup:
+	  return "Action not possible before the network is configured";
+	case error::network_already_setup:
+	  return "Network can be configured only once";
+	case error::no_commit_version:
+	  return "Transaction is read-only and therefore does not have a commit version";
+	case error::transaction_too_large:
+	  return "Transaction exceeds byte limit";
+	case error::key_too_large:
+	  return "Key length exceeds limit";
+	case error::value_too_large:
+	  return "Value length exceeds limit";
+	case error::api_version_unset:
+	  return "API version is not set";
+	case error::api_version_already_set:
+	  return "API version may be set only once";
+	case error::api_version_not_supported:
+	  return "API version not supported";
+	default:
+	  return "UNKNOWN_ERROR";
+  }
+}
+
+fdb_bool_t fdb_error_predicate(int predicate_test, fdb_error_t code) {
+  switch (predicate_test) {
+	case FDBErrorPredicate::FDB_ERROR_PREDICATE_RETRYABLE:
+	  return error::is_retryable(code);
+	case FDBErrorPredicate::FDB_ERROR_PREDICATE_MAYBE_COMMITTED:
+	  return error::is_maybe_committed(code);
+	case FDBErrorPredicate::FDB_ERROR_PREDICATE_RETRYABLE_NOT_COMMITTED:
+	  return error::is_retryable(code) && !error::is_maybe_committed(code);
+	default:
+	  return 0;
+  }
+}
+
+fdb_error_t fdb_select_api_version_impl(int runtime_version, int header_version) {
+  if (runtime_version > fdb_get_max_api_version() || header_version > fdb_get_max_api_version()) {
+	return error::api_version_not_supported;
+  }
+  if (selected_api_version != 0) {
+	return selected_api_version == runtime_version ? error::success : error::api_version_already_set;
+  }
+  selected_api_version = runtime_version;
+  return error::success;
+}
+
+int fdb_get_max_api_version(void) {
+  return 610;
+}
+
+fdb_error_t fdb_network_set_option(FDBNetworkOption, uint8_t const *, int) {
+  // tracing and TLS options have no meaning in memory
+  return error::success;
+}
+
+fdb_error_t fdb_setup_network(void) {
+  if (selected_api_version == 0) {
+	return error::api_version_unset;
+  }
+  return setup_network();
+}
+
+fdb_error_t fdb_run_network(void) {
+  return run_network();
+}
+
+fdb_error_t fdb_stop_network(void) {
+  return stop_network();
+}
+
+// futures
+
+void fdb_future_cancel(FDBFuture *f) {
+  cancel(f);
+}
+
+void fdb_future_release_memory(FDBFuture *) {
+}
+
+void fdb_future_destroy(FDBFuture *f) {
+  cancel(f);
+  release(f);
+}
+
+fdb_error_t fdb_future_block_until_ready(FDBFuture *f) {
+  std::unique_lock lock(f->mutex);
+  f->cv.wait(lock, [f] { return f->ready; });
+  return error::success;
+}
+
+fdb_bool_t fdb_future_is_ready(FDBFuture *f) {
+  std::scoped_lock lock(f->mutex);
+  return f->ready;
+}
+
+fdb_error_t fdb_future_set_callback(FDBFuture *f, FDBCallback callback, void *callback_parameter) {
+  {
+	std::scoped_lock lock(f->mutex);
+	if (!f->ready) {
+	  f->callback = callback;
+	  f->callback_parameter = callback_parameter;
+	  return error::success;
+	}
+  }
+  callback(f, callback_parameter);
+  return error::success;
+}
+
+fdb_error_t fdb_future_get_error(FDBFuture *f) {
+  std::scoped_lock lock(f->mutex);
+  return f->ready ? f->error : error::client_invalid_operation;
+}
+
+fdb_error_t fdb_future_get_version(FDBFuture *f, int64_t *out_version) {
+  if (auto error = fdb_future_get_error(f); error) {
+	return error;
+  }
+  *out_version = f->version;
+  return error::success;
+}
+
+fdb_error_t fdb_future_get_key(FDBFuture *f, uint8_t const **out_key, int *out_key_length) {
+  if (auto error = fdb_future_get_error(f); error) {
+	return error;
+  }
+  *out_key = reinterpret_cast<const uint8_t *>(f->key.data());
+  *out_key_length = int(f->key.size());
+  return error::success;
+}
+
+fdb_error_t fdb_future_get_value(FDBFuture *f, fdb_bool_t *out_present, uint8_t const **out_value,
+								 int *out_value_length) {
+  if (auto error = fdb_future_get_error(f); error) {
+	return error;
+  }
+  *out_present = f->value.has_value();
+  *out_value = f->value ? reinterpret_cast<const uint8_t *>(f->value->data()) : nullptr;
+  *out_value_length = f->value ? int(f->value->size()) : 0;
+  return error::success;
+}
+
+fdb_error_t fdb_future_get_keyvalue_array(FDBFuture *f, FDBKeyValue const **out_kv, int *out_count,
+										  fdb_bool_t *out_more) {
+  if (auto error = fdb_future_get_error(f); error) {
+	return error;
+  }
+  *out_kv = f->kv.data();
+  *out_count = int(f->kv.size());
+  *out_more = f->more;
+  return error::success;
+}
+
+// database
+
+fdb_error_t fdb_create_database(const char *cluster_file_path, FDBDatabase **out_database) {
+  if (selected_api_version == 0) {
+	return error::api_version_unset;
+  }
+  *out_database = new FDB_database{open_store(cluster_file_path ? cluster_file_path : "")};
+  return error::success;
+}
+
+void fdb_database_destroy(FDBDatabase *d) {
+  delete d;
+}
+
+fdb_error_t fdb_database_set_option(FDBDatabase *d, FDBDatabaseOption option, uint8_t const *value,
+									int value_length) {
+  auto &defaults = d->transaction_defaults;
+  switch (option) {
+	case FDBDatabaseOption::FDB_DB_OPTION_MAX_WATCHES: {
+	  std::int64_t max_watches = 0;
+	  if (auto error = int_option(value, value_length, max_watches); error) {
+		return error;
+	  }
+	  if (max_watches < 0 || max_watches > 1'000'000) {
+		return error::invalid_option_value;
+	  }
+	  d->max_watches = int(max_watches);
+	  return error::success;
+	}
+	case FDBDatabaseOption::FDB_DB_OPTION_TRANSACTION_TIMEOUT:
+	  return int_option(value, value_length, defaults.timeout);
+	case FDBDatabaseOption::FDB_DB_OPTION_TRANSACTION_RETRY_LIMIT:
+	  return int_option(value, value_length, defaults.retry_limit);
+	case FDBDatabaseOption::FDB_DB_OPTION_TRANSACTION_MAX_RETRY_DELAY:
+	  return int_option(value, value_length, defaults.max_retry_delay);
+	case FDBDatabaseOption::FDB_DB_OPTION_TRANSACTION_SIZE_LIMIT:
+	  return int_option(value, value_length, defaults.size_limit);
+	default:
+	  return error::success;
+  }
+}
+
+fdb_error_t fdb_database_create_transaction(FDBDatabase *d, FDBTransaction **out_transaction) {
+  *out_transaction = new FDB_transaction(d->data, d->transaction_defaults, d->max_watches);
+  return error::success;
+}
+
+// transaction
+
+void fdb_transaction_destroy(FDBTransaction *tr) {
+  delete tr;
+}
+
+void fdb_transaction_cancel(FDBTransaction *tr) {
+  tr->reset();
+}
+
+fdb_error_t fdb_transaction_set_option(FDBTransaction *tr, FDBTransactionOption option, uint8_t const *value,
+									   int value_length) {
+  return tr->set_option(option, value, value_length);
+}
+
+void fdb_transaction_set_read_version(FDBTransaction *tr, int64_t version) {
+  tr->set_read_version(version);
+}
+
+FDBFuture *fdb_transaction_get_read_version(FDBTransaction *tr) {
+  return tr->get_read_version();
+}
+
+FDBFuture *fdb_transaction_get(FDBTransaction *tr, uint8_t const *key_name, int key_name_length,
+							   fdb_bool_t snapshot) {
+  return tr->get(to_view(key_name, key_name_length), snapshot);
+}
+
+FDBFuture *fdb_transaction_get_key(FDBTransaction *tr, uint8_t const *key_name, int key_name_length,
+								   fdb_bool_t or_equal, int offset, fdb_bool_t snapshot) {
+  return tr->get_key(key_selector{to_view(key_name, key_name_length), bool(or_equal), offset}, snapshot);
+}
+
+FDBFuture *fdb_transaction_get_range(FDBTransaction *tr,
+									 uint8_t const *begin_key_name, int begin_key_name_length,
+									 fdb_bool_t begin_or_equal, int begin_offset,
+									 uint8_t const *end_key_name, int end_key_name_length,
+									 fdb_bool_t end_or_equal, int end_offset,
+									 int limit, int target_bytes, FDBStreamingMode mode, int iteration,
+									 fdb_bool_t snapshot, fdb_bool_t reverse) {
+  return tr->get_range(
+	  key_selector{to_view(begin_key_name, begin_key_name_length), bool(begin_or_equal), begin_offset},
+	  key_selector{to_view(end_key_name, end_key_name_length), bool(end_or_equal), end_offset},
+	  range_options{limit, target_bytes, mode, iteration, bool(snapshot), bool(reverse)});
+}
+
+void fdb_transaction_set(FDBTransaction *tr, uint8_t const *key_name, int key_name_length, uint8_t const *value,
+						 int value_length) {
+  tr->set(to_view(key_name, key_name_length), to_view(value, value_length));
+}
+
+void fdb_transaction_atomic_op(FDBTransaction *tr, uint8_t const *key_name, int key_name_length,
+							   uint8_t const *param, int param_length, FDBMutationType operation_type) {
+  tr->atomic_op(to_view(key_name, key_name_length), to_view(param, param_length), operation_type);
+}
+
+void fdb_transaction_clear(FDBTransaction *tr, uint8_t const *key_name, int key_name_length) {
+  tr->clear(to_view(key_name, key_name_length));
+}
+
+void fdb_transaction_clear_range(FDBTransaction *tr, uint8_t const *begin_key_name, int begin_key_name_length,
+								 uint8_t const *end_key_name, int end_key_name_length) {
+  tr->clear_range(to_view(begin_key_name, begin_key_name_length), to_view(end_key_name, end_key_name_length));
+}
+
+FDBFuture *fdb_transaction_watch(FDBTransaction *tr, uint8_t const *key_name, int key_name_length) {
+  return tr->watch(to_view(key_name, key_name_length));
+}
+
+FDBFuture *fdb_transaction_commit(FDBTransaction *tr) {
+  return tr->commit();
+}
+
+fdb_error_t fdb_transaction_get_committed_version(FDBTransaction *tr, int64_t *out_version) {
+  return tr->get_committed_version(out_version);
+}
+
+FDBFuture *fdb_transaction_get_versionstamp(FDBTransaction *tr) {
+  return tr->get_versionstamp();
+}
+
+FDBFuture *fdb_transaction_on_error(FDBTransaction *tr, fdb_error_t error) {
+  return tr->on_error(error);
+}
+
+void fdb_transaction_reset(FDBTransaction *tr) {
+  tr->reset();
+}
+
+fdb_error_t fdb_transaction_add_conflict_range(FDBTransaction *tr, uint8_t const *begin_key_name,
+											   int begin_key_name_length, uint8_t const *end_key_name,
+											   int end_key_name_length, FDBConflictRangeType type) {
+  return tr->add_conflict_range(to_view(begin_key_name, begin_key_name_length),
+								to_view(end_key_name, end_key_name_length), type);
+}
+
+}// extern "C"
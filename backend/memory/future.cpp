@@ -0,0 +1,175 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <map>
+
+#include "error.hh"
+#include "future.hh"
+
+namespace {
+
+/**
+ * Tasks executed by the thread running the network, ordered by the time point they have to be executed at
+ */
+struct network {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::multimap<ffdb::memory::clock::time_point, std::function<void()>> tasks;
+
+  bool setup = false;
+  bool stopped = false;
+};
+
+network &get_network() {
+  // never destroyed, futures may still be completed by static objects destroyed at exit
+  static auto *instance = new network();
+  return *instance;
+}
+
+}// namespace
+
+namespace ffdb::memory {
+
+FDB_future *make_future() {
+  return new FDB_future();
+}
+
+FDB_future *make_error_future(fdb_error_t error) {
+  auto *future = make_future();
+  complete(future, error);
+  return future;
+}
+
+void reference(FDB_future *future) {
+  future->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void release(FDB_future *future) {
+  if (future->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+	delete future;
+  }
+}
+
+bool complete(FDB_future *future, fdb_error_t error) {
+  FDBCallback callback = nullptr;
+  void *parameter = nullptr;
+  {
+	std::scoped_lock lock(future->mutex);
+	if (future->ready) {
+	  return false;
+	}
+	future->ready = true;
+	future->error = error;
+	callback = std::exchange(future->callback, nullptr);
+	parameter = future->callback_parameter;
+  }
+  future->cv.notify_all();
+  if (callback) {
+	callback(future, parameter);
+  }
+  return true;
+}
+
+void cancel(FDB_future *future) {
+  std::function<void()> on_cancel;
+  {
+	std::scoped_lock lock(future->mutex);
+	if (future->ready) {
+	  return;
+	}
+	on_cancel = std::move(future->on_cancel);
+  }
+  if (complete(future, error::operation_cancelled) && on_cancel) {
+	on_cancel();
+  }
+}
+
+void post(std::function<void()> task, clock::duration delay) {
+  auto &net = get_network();
+  {
+	std::scoped_lock lock(net.mutex);
+	if (!net.stopped) {
+	  net.tasks.emplace(clock::now() + delay, std::move(task));
+	  net.cv.notify_one();
+	  return;
+	}
+  }
+  task();
+}
+
+fdb_error_t setup_network() {
+  auto &net = get_network();
+  std::scoped_lock lock(net.mutex);
+  if (net.setup) {
+	return error::network_already_setup;
+  }
+  net.setup = true;
+  return error::success;
+}
+
+fdb_error_t run_network() {
+  auto &net = get_network();
+  std::unique_lock lock(net.mutex);
+  if (!net.setup) {
+	return error::network_not_setup;
+  }
+  while (!net.stopped) {
+	if (net.tasks.empty()) {
+	  net.cv.wait(lock);
+	  continue;
+	}
+	auto first = net.tasks.begin();
+	if (first->first > clock::now()) {
+	  net.cv.wait_until(lock, first->first);
+	  continue;
+	}
+	auto task = std::move(first->second);
+	net.tasks.erase(first);
+	lock.unlock();
+	task();
+	lock.lock();
+  }
+  // remaining tasks are executed right away so that no future is left pending
+  auto remaining = std::move(net.tasks);
+  lock.unlock();
+  for (auto &[time, task] : remaining) {
+	task();
+  }
+  return error::success;
+}
+
+fdb_error_t stop_network() {
+  auto &net = get_network();
+  {
+	std::scoped_lock lock(net.mutex);
+	if (!net.setup) {
+	  return error::network_not_setup;
+	}
+	net.stopped = true;
+  }
+  net.cv.notify_all();
+  return error::success;
+}
+
+}// namespace ffdb::memory
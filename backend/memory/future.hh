@@ -0,0 +1,110 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FREE_FDB_BACKEND_MEMORY_FUTURE_HH
+#define FREE_FDB_BACKEND_MEMORY_FUTURE_HH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define FDB_API_VERSION 610
+#include <foundationdb/fdb_c.h>
+
+/**
+ * Future of the in-memory backend, the result is set by the operation creating it (most of the time before returning
+ * it to the caller) then the future is marked as ready.
+ * Futures are reference counted as the backend may keep one after the user destroyed it (watch, versionstamp).
+ */
+struct FDB_future {
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool ready = false;
+  fdb_error_t error = 0;
+
+  FDBCallback callback = nullptr;
+  void *callback_parameter = nullptr;
+
+  //! called once if the future is cancelled before being ready (used to unregister a pending watch)
+  std::function<void()> on_cancel;
+
+  std::atomic<int> references{1};
+
+  // results, only one of them is set depending on the operation the future come from
+  std::int64_t version = 0;
+  std::string key;
+  std::optional<std::string> value;
+  std::vector<std::pair<std::string, std::string>> rows;
+  std::vector<FDBKeyValue> kv;
+  bool more = false;
+};
+
+namespace ffdb::memory {
+
+using clock = std::chrono::steady_clock;
+
+[[nodiscard]] FDB_future *make_future();
+
+[[nodiscard]] FDB_future *make_error_future(fdb_error_t error);
+
+void reference(FDB_future *future);
+
+void release(FDB_future *future);
+
+/**
+ * Set the future as ready with the provided error (0 on success) and call its callback on the calling thread.
+ * Results of the future have to be set beforehand, completing a future already ready does nothing.
+ *
+ * @return true if the future has been completed by this call
+ */
+bool complete(FDB_future *future, fdb_error_t error = 0);
+
+/**
+ * Complete the future with operation_cancelled if it isn't ready yet.
+ */
+void cancel(FDB_future *future);
+
+/**
+ * Execute a task on the network thread (the one calling fdb_run_network) after the provided delay.
+ * Once the network is stopped, the task is executed right away by the calling thread.
+ */
+void post(std::function<void()> task, clock::duration delay = clock::duration::zero());
+
+fdb_error_t setup_network();
+
+fdb_error_t run_network();
+
+fdb_error_t stop_network();
+
+}// namespace ffdb::memory
+
+#endif//FREE_FDB_BACKEND_MEMORY_FUTURE_HH
@@ -0,0 +1,229 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/*
+ * FoundationDB C API (version 610) as implemented by the in-memory backend of free_fdb.
+ *
+ * Only the part of the API used by free_fdb is declared, with the same signatures and enumeration values as the
+ * header shipped with the FoundationDB client so that free_fdb builds unchanged against either of them.
+ * @see https://apple.github.io/foundationdb/api-c.html
+ */
+
+#ifndef FDB_C_H
+#define FDB_C_H
+
+#if !defined(FDB_API_VERSION)
+#error You must #define FDB_API_VERSION prior to including fdb_c.h (current version is 610)
+#elif FDB_API_VERSION > 610
+#error Requested API version requires a newer version of this header
+#endif
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int fdb_error_t;
+typedef int fdb_bool_t;
+
+typedef struct FDB_future FDBFuture;
+typedef struct FDB_database FDBDatabase;
+typedef struct FDB_transaction FDBTransaction;
+
+typedef enum {
+  FDB_NET_OPTION_TRACE_ENABLE = 30,
+  FDB_NET_OPTION_TRACE_ROLL_SIZE = 31,
+  FDB_NET_OPTION_TRACE_MAX_LOGS_SIZE = 32,
+  FDB_NET_OPTION_TRACE_LOG_GROUP = 33
+} FDBNetworkOption;
+
+typedef enum {
+  FDB_DB_OPTION_LOCATION_CACHE_SIZE = 10,
+  FDB_DB_OPTION_MAX_WATCHES = 20,
+  FDB_DB_OPTION_MACHINE_ID = 21,
+  FDB_DB_OPTION_DATACENTER_ID = 22,
+  FDB_DB_OPTION_TRANSACTION_TIMEOUT = 500,
+  FDB_DB_OPTION_TRANSACTION_RETRY_LIMIT = 501,
+  FDB_DB_OPTION_TRANSACTION_MAX_RETRY_DELAY = 502,
+  FDB_DB_OPTION_TRANSACTION_SIZE_LIMIT = 503
+} FDBDatabaseOption;
+
+typedef enum {
+  FDB_TR_OPTION_CAUSAL_WRITE_RISKY = 10,
+  FDB_TR_OPTION_CAUSAL_READ_RISKY = 20,
+  FDB_TR_OPTION_CAUSAL_READ_DISABLE = 21,
+  FDB_TR_OPTION_NEXT_WRITE_NO_WRITE_CONFLICT_RANGE = 30,
+  FDB_TR_OPTION_READ_YOUR_WRITES_DISABLE = 51,
+  FDB_TR_OPTION_READ_AHEAD_DISABLE = 52,
+  FDB_TR_OPTION_DURABILITY_DATACENTER = 110,
+  FDB_TR_OPTION_DURABILITY_RISKY = 120,
+  FDB_TR_OPTION_PRIORITY_SYSTEM_IMMEDIATE = 200,
+  FDB_TR_OPTION_PRIORITY_BATCH = 201,
+  FDB_TR_OPTION_INITIALIZE_NEW_DATABASE = 300,
+  FDB_TR_OPTION_ACCESS_SYSTEM_KEYS = 301,
+  FDB_TR_OPTION_READ_SYSTEM_KEYS = 302,
+  FDB_TR_OPTION_DEBUG_RETRY_LOGGING = 401,
+  FDB_TR_OPTION_TRANSACTION_LOGGING_ENABLE = 402,
+  FDB_TR_OPTION_TIMEOUT = 500,
+  FDB_TR_OPTION_RETRY_LIMIT = 501,
+  FDB_TR_OPTION_MAX_RETRY_DELAY = 502,
+  FDB_TR_OPTION_SIZE_LIMIT = 503,
+  FDB_TR_OPTION_SNAPSHOT_RYW_ENABLE = 600,
+  FDB_TR_OPTION_SNAPSHOT_RYW_DISABLE = 601,
+  FDB_TR_OPTION_LOCK_AWARE = 700,
+  FDB_TR_OPTION_USED_DURING_COMMIT_PROTECTION_DISABLE = 701,
+  FDB_TR_OPTION_READ_LOCK_AWARE = 702
+} FDBTransactionOption;
+
+typedef enum {
+  FDB_STREAMING_MODE_WANT_ALL = -2,
+  FDB_STREAMING_MODE_ITERATOR = -1,
+  FDB_STREAMING_MODE_EXACT = 0,
+  FDB_STREAMING_MODE_SMALL = 1,
+  FDB_STREAMING_MODE_MEDIUM = 2,
+  FDB_STREAMING_MODE_LARGE = 3,
+  FDB_STREAMING_MODE_SERIAL = 4
+} FDBStreamingMode;
+
+typedef enum {
+  FDB_MUTATION_TYPE_ADD = 2,
+  FDB_MUTATION_TYPE_AND = 6,
+  FDB_MUTATION_TYPE_BIT_AND = 6,
+  FDB_MUTATION_TYPE_OR = 7,
+  FDB_MUTATION_TYPE_BIT_OR = 7,
+  FDB_MUTATION_TYPE_XOR = 8,
+  FDB_MUTATION_TYPE_BIT_XOR = 8,
+  FDB_MUTATION_TYPE_APPEND_IF_FITS = 9,
+  FDB_MUTATION_TYPE_MAX = 12,
+  FDB_MUTATION_TYPE_MIN = 13,
+  FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_KEY = 14,
+  FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_VALUE = 15,
+  FDB_MUTATION_TYPE_BYTE_MIN = 16,
+  FDB_MUTATION_TYPE_BYTE_MAX = 17,
+  FDB_MUTATION_TYPE_COMPARE_AND_CLEAR = 20
+} FDBMutationType;
+
+typedef enum {
+  FDB_CONFLICT_RANGE_TYPE_READ = 0,
+  FDB_CONFLICT_RANGE_TYPE_WRITE = 1
+} FDBConflictRangeType;
+
+typedef enum {
+  FDB_ERROR_PREDICATE_RETRYABLE = 50000,
+  FDB_ERROR_PREDICATE_MAYBE_COMMITTED = 50001,
+  FDB_ERROR_PREDICATE_RETRYABLE_NOT_COMMITTED = 50002
+} FDBErrorPredicate;
+
+#pragma pack(push, 4)
+typedef struct keyvalue {
+  const void *key;
+  int key_length;
+  const void *value;
+  int value_length;
+} FDBKeyValue;
+#pragma pack(pop)
+
+typedef void (*FDBCallback)(FDBFuture *future, void *callback_parameter);
+
+/* errors */
+const char *fdb_get_error(fdb_error_t code);
+fdb_bool_t fdb_error_predicate(int predicate_test, fdb_error_t code);
+
+/* network */
+fdb_error_t fdb_select_api_version_impl(int runtime_version, int header_version);
+#define fdb_select_api_version(v) fdb_select_api_version_impl(v, FDB_API_VERSION)
+int fdb_get_max_api_version(void);
+fdb_error_t fdb_network_set_option(FDBNetworkOption option, uint8_t const *value, int value_length);
+fdb_error_t fdb_setup_network(void);
+fdb_error_t fdb_run_network(void);
+fdb_error_t fdb_stop_network(void);
+
+/* futures */
+void fdb_future_cancel(FDBFuture *f);
+void fdb_future_release_memory(FDBFuture *f);
+void fdb_future_destroy(FDBFuture *f);
+fdb_error_t fdb_future_block_until_ready(FDBFuture *f);
+fdb_bool_t fdb_future_is_ready(FDBFuture *f);
+fdb_error_t fdb_future_set_callback(FDBFuture *f, FDBCallback callback, void *callback_parameter);
+fdb_error_t fdb_future_get_error(FDBFuture *f);
+fdb_error_t fdb_future_get_version(FDBFuture *f, int64_t *out_version);
+fdb_error_t fdb_future_get_key(FDBFuture *f, uint8_t const **out_key, int *out_key_length);
+fdb_error_t fdb_future_get_value(FDBFuture *f, fdb_bool_t *out_present, uint8_t const **out_value,
+                                 int *out_value_length);
+fdb_error_t fdb_future_get_keyvalue_array(FDBFuture *f, FDBKeyValue const **out_kv, int *out_count,
+                                          fdb_bool_t *out_more);
+
+/* database */
+fdb_error_t fdb_create_database(const char *cluster_file_path, FDBDatabase **out_database);
+void fdb_database_destroy(FDBDatabase *d);
+fdb_error_t fdb_database_set_option(FDBDatabase *d, FDBDatabaseOption option, uint8_t const *value,
+                                    int value_length);
+fdb_error_t fdb_database_create_transaction(FDBDatabase *d, FDBTransaction **out_transaction);
+
+/* transaction */
+void fdb_transaction_destroy(FDBTransaction *tr);
+void fdb_transaction_cancel(FDBTransaction *tr);
+fdb_error_t fdb_transaction_set_option(FDBTransaction *tr, FDBTransactionOption option, uint8_t const *value,
+                                       int value_length);
+void fdb_transaction_set_read_version(FDBTransaction *tr, int64_t version);
+FDBFuture *fdb_transaction_get_read_version(FDBTransaction *tr);
+FDBFuture *fdb_transaction_get(FDBTransaction *tr, uint8_t const *key_name, int key_name_length,
+                               fdb_bool_t snapshot);
+FDBFuture *fdb_transaction_get_key(FDBTransaction *tr, uint8_t const *key_name, int key_name_length,
+                                   fdb_bool_t or_equal, int offset, fdb_bool_t snapshot);
+FDBFuture *fdb_transaction_get_range(FDBTransaction *tr,
+                                     uint8_t const *begin_key_name, int begin_key_name_length,
+                                     fdb_bool_t begin_or_equal, int begin_offset,
+                                     uint8_t const *end_key_name, int end_key_name_length,
+                                     fdb_bool_t end_or_equal, int end_offset,
+                                     int limit, int target_bytes, FDBStreamingMode mode, int iteration,
+                                     fdb_bool_t snapshot, fdb_bool_t reverse);
+void fdb_transaction_set(FDBTransaction *tr, uint8_t const *key_name, int key_name_length, uint8_t const *value,
+                         int value_length);
+void fdb_transaction_atomic_op(FDBTransaction *tr, uint8_t const *key_name, int key_name_length,
+                               uint8_t const *param, int param_length, FDBMutationType operation_type);
+void fdb_transaction_clear(FDBTransaction *tr, uint8_t const *key_name, int key_name_length);
+void fdb_transaction_clear_range(FDBTransaction *tr, uint8_t const *begin_key_name, int begin_key_name_length,
+                                 uint8_t const *end_key_name, int end_key_name_length);
+FDBFuture *fdb_transaction_watch(FDBTransaction *tr, uint8_t const *key_name, int key_name_length);
+FDBFuture *fdb_transaction_commit(FDBTransaction *tr);
+fdb_error_t fdb_transaction_get_committed_version(FDBTransaction *tr, int64_t *out_version);
+FDBFuture *fdb_transaction_get_versionstamp(FDBTransaction *tr);
+FDBFuture *fdb_transaction_on_error(FDBTransaction *tr, fdb_error_t error);
+void fdb_transaction_reset(FDBTransaction *tr);
+fdb_error_t fdb_transaction_add_conflict_range(FDBTransaction *tr, uint8_t const *begin_key_name,
+                                               int begin_key_name_length, uint8_t const *end_key_name,
+                                               int end_key_name_length, FDBConflictRangeType type);
+
+#define FDB_KEYSEL_LAST_LESS_THAN(k, l) k, l, 0, 0
+#define FDB_KEYSEL_LAST_LESS_OR_EQUAL(k, l) k, l, 1, 0
+#define FDB_KEYSEL_FIRST_GREATER_THAN(k, l) k, l, 1, 1
+#define FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(k, l) k, l, 0, 1
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FDB_C_H */
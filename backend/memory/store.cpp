@@ -0,0 +1,418 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include "error.hh"
+#include "store.hh"
+
+namespace {
+
+std::string resized(const std::optional<std::string> &value, std::size_t size) {
+  std::string result = value.value_or(std::string{});
+  result.resize(size, '\0');
+  return result;
+}
+
+/**
+ * Compare two little-endian unsigned integers of the same size
+ */
+int compare_little_endian(std::string_view lhs, std::string_view rhs) {
+  for (std::size_t i = lhs.size(); i > 0; --i) {
+	auto l = static_cast<std::uint8_t>(lhs[i - 1]);
+	auto r = static_cast<std::uint8_t>(rhs[i - 1]);
+	if (l != r) {
+	  return l < r ? -1 : 1;
+	}
+  }
+  return 0;
+}
+
+/**
+ * Replace the incomplete versionstamp of the provided key/value, its position is given by the 4 trailing bytes
+ * (little-endian) of the parameter as defined by the API version 520 and above.
+ *
+ * @return the key/value with the versionstamp set, std::nullopt if the position is invalid
+ */
+std::optional<std::string> fill_versionstamp(std::string_view param, const std::string &stamp) {
+  if (param.size() < 4) {
+	return std::nullopt;
+  }
+  std::uint32_t offset = 0;
+  for (std::size_t i = 0; i < 4; ++i) {
+	offset |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(param[param.size() - 4 + i])) << (8 * i);
+  }
+  std::string result(param.substr(0, param.size() - 4));
+  if (std::size_t(offset) + stamp.size() > result.size()) {
+	return std::nullopt;
+  }
+  result.replace(offset, stamp.size(), stamp);
+  return result;
+}
+
+void push_version(std::vector<ffdb::memory::stored_version> &versions, std::optional<std::string> value,
+				  std::int64_t version, std::int64_t oldest) {
+  if (!versions.empty() && versions.back().version == version) {
+	versions.back().value = std::move(value);
+  } else {
+	versions.push_back({version, std::move(value)});
+  }
+  // versions older than the MVCC window can't be read anymore, except the newest of them which is still visible
+  auto first_kept = std::find_if(versions.begin(), versions.end(), [oldest](const auto &v) {
+	return v.version > oldest;
+  });
+  if (first_kept != versions.begin()) {
+	versions.erase(versions.begin(), std::prev(first_kept));
+  }
+}
+
+}// namespace
+
+namespace ffdb::memory {
+
+std::optional<std::string> apply_atomic(FDBMutationType op, const std::optional<std::string> &current,
+										std::string_view param) {
+  switch (op) {
+	case FDBMutationType::FDB_MUTATION_TYPE_ADD: {
+	  if (!current) {
+		return std::string(param);
+	  }
+	  std::string result = resized(current, param.size());
+	  unsigned carry = 0;
+	  for (std::size_t i = 0; i < param.size(); ++i) {
+		unsigned sum = static_cast<std::uint8_t>(result[i]) + static_cast<std::uint8_t>(param[i]) + carry;
+		result[i] = static_cast<char>(sum & 0xFFu);
+		carry = sum >> 8u;
+	  }
+	  return result;
+	}
+	case FDBMutationType::FDB_MUTATION_TYPE_BIT_AND: {
+	  if (!current) {
+		return std::string(param);
+	  }
+	  std::string result = resized(current, param.size());
+	  for (std::size_t i = 0; i < param.size(); ++i) {
+		result[i] = static_cast<char>(result[i] & param[i]);
+	  }
+	  return result;
+	}
+	case FDBMutationType::FDB_MUTATION_TYPE_BIT_OR:
+	case FDBMutationType::FDB_MUTATION_TYPE_BIT_XOR: {
+	  std::string result = resized(current, param.size());
+	  for (std::size_t i = 0; i < param.size(); ++i) {
+		result[i] = static_cast<char>(op == FDBMutationType::FDB_MUTATION_TYPE_BIT_OR ? result[i] | param[i]
+																				 : result[i] ^ param[i]);
+	  }
+	  return result;
+	}
+	case FDBMutationType::FDB_MUTATION_TYPE_APPEND_IF_FITS: {
+	  std::string result = current.value_or(std::string{});
+	  if (result.size() + param.size() <= max_value_size) {
+		result.append(param);
+	  }
+	  return result;
+	}
+	case FDBMutationType::FDB_MUTATION_TYPE_MAX:
+	case FDBMutationType::FDB_MUTATION_TYPE_MIN: {
+	  if (!current) {
+		return std::string(param);
+	  }
+	  std::string result = resized(current, param.size());
+	  int cmp = compare_little_endian(result, param);
+	  bool keep_current = op == FDBMutationType::FDB_MUTATION_TYPE_MAX ? cmp >= 0 : cmp <= 0;
+	  return keep_current ? result : std::string(param);
+	}
+	case FDBMutationType::FDB_MUTATION_TYPE_BYTE_MAX:
+	  return !current || *current < param ? std::string(param) : *current;
+	case FDBMutationType::FDB_MUTATION_TYPE_BYTE_MIN:
+	  return !current || param < *current ? std::string(param) : *current;
+	case FDBMutationType::FDB_MUTATION_TYPE_COMPARE_AND_CLEAR:
+	  if (current && *current == param) {
+		return std::nullopt;
+	  }
+	  return current;
+	default:
+	  return current;
+  }
+}
+
+const std::string *visible_at(const std::vector<stored_version> &versions, std::int64_t read_version) {
+  for (auto it = versions.rbegin(); it != versions.rend(); ++it) {
+	if (it->version <= read_version) {
+	  return it->value ? &*it->value : nullptr;
+	}
+  }
+  return nullptr;
+}
+
+store::store() : _origin(clock::now()) {}
+
+std::int64_t store::now_version() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - _origin).count() + 1;
+}
+
+std::int64_t store::oldest_version() const {
+  return now_version() - mvcc_window;
+}
+
+std::int64_t store::read_version() {
+  std::shared_lock lock(mutex);
+  auto version = std::max(_committed_version, now_version());
+  // commits have to be done at a version greater than every read version given
+  auto last = _last_read_version.load();
+  while (last < version && !_last_read_version.compare_exchange_weak(last, version)) {
+  }
+  return version;
+}
+
+fdb_error_t store::check_read_version(std::int64_t version) const {
+  if (version < oldest_version()) {
+	return error::transaction_too_old;
+  }
+  if (version > std::max(_committed_version, now_version())) {
+	return error::future_version;
+  }
+  return error::success;
+}
+
+std::optional<std::string> store::latest(std::string_view key) const {
+  auto it = data.find(key);
+  if (it == data.end() || it->second.empty()) {
+	return std::nullopt;
+  }
+  return it->second.back().value;
+}
+
+void store::write(const std::string &key, std::optional<std::string> value, std::int64_t version) {
+  auto it = data.find(key);
+  if (it == data.end()) {
+	if (!value) {
+	  return;
+	}
+	it = data.emplace(key, std::vector<stored_version>{}).first;
+  }
+  push_version(it->second, std::move(value), version, oldest_version());
+  if (it->second.size() == 1 && !it->second.front().value && it->second.front().version <= oldest_version()) {
+	data.erase(it);
+  }
+}
+
+void store::apply(const mutation &m, std::int64_t version, const std::string &stamp, std::vector<key_range> &writes) {
+  switch (m.type) {
+	case mutation_type::set:
+	  write(m.key, m.param, version);
+	  writes.push_back({m.key, key_after(m.key)});
+	  break;
+	case mutation_type::clear:
+	  write(m.key, std::nullopt, version);
+	  writes.push_back({m.key, key_after(m.key)});
+	  break;
+	case mutation_type::clear_range: {
+	  auto oldest = oldest_version();
+	  for (auto it = data.lower_bound(m.key); it != data.end() && it->first < m.param; ++it) {
+		if (!it->second.empty() && it->second.back().value) {
+		  push_version(it->second, std::nullopt, version, oldest);
+		}
+	  }
+	  writes.push_back({m.key, m.param});
+	  break;
+	}
+	case mutation_type::atomic:
+	  if (m.op == FDBMutationType::FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_KEY) {
+		if (auto key = fill_versionstamp(m.key, stamp)) {
+		  write(*key, m.param, version);
+		  writes.push_back({*key, key_after(*key)});
+		}
+	  } else if (m.op == FDBMutationType::FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_VALUE) {
+		if (auto value = fill_versionstamp(m.param, stamp)) {
+		  write(m.key, std::move(value), version);
+		  writes.push_back({m.key, key_after(m.key)});
+		}
+	  } else {
+		write(m.key, apply_atomic(m.op, latest(m.key), m.param), version);
+		writes.push_back({m.key, key_after(m.key)});
+	  }
+	  break;
+  }
+}
+
+bool store::conflicts(const commit_request &request) const {
+  if (request.read_conflicts.empty()) {
+	return false;
+  }
+  for (auto it = _log.rbegin(); it != _log.rend() && it->version > *request.read_version; ++it) {
+	for (const auto &written : it->writes) {
+	  for (const auto &read : request.read_conflicts) {
+		if (written.intersects(read)) {
+		  return true;
+		}
+	  }
+	}
+  }
+  return false;
+}
+
+commit_result store::commit(const commit_request &request) {
+  commit_result result;
+  std::vector<std::pair<FDB_future *, fdb_error_t>> ready;
+  {
+	std::unique_lock lock(mutex);
+	if (request.read_version && !request.read_conflicts.empty()) {
+	  if (*request.read_version < oldest_version()) {
+		result.error = error::transaction_too_old;
+		return result;
+	  }
+	  if (conflicts(request)) {
+		result.error = error::not_committed;
+		return result;
+	  }
+	}
+
+	std::vector<key_range> writes;
+	if (!request.mutations.empty() || !request.write_conflicts.empty()) {
+	  auto version = std::max({_committed_version + 1, _last_read_version.load() + 1, now_version()});
+
+	  // 8 bytes big-endian commit version followed by the 2 bytes batch number (always 0, one commit per batch)
+	  std::string stamp(10, '\0');
+	  for (std::size_t i = 0; i < 8; ++i) {
+		stamp[i] = static_cast<char>((static_cast<std::uint64_t>(version) >> (8 * (7 - i))) & 0xFFu);
+	  }
+
+	  for (const auto &m : request.mutations) {
+		apply(m, version, stamp, writes);
+	  }
+	  trigger_watches(writes, ready);
+
+	  writes.insert(writes.end(), request.write_conflicts.begin(), request.write_conflicts.end());
+	  _committed_version = version;
+	  _log.push_back({version, writes});
+	  while (!_log.empty() && _log.front().version < oldest_version()) {
+		_log.pop_front();
+	  }
+	  result.version = version;
+	  result.versionstamp = std::move(stamp);
+	}
+	register_watches(request, writes, ready);
+  }
+  // watches are triggered from the network thread, as the callbacks of FoundationDB are
+  for (auto [future, error] : ready) {
+	post([future = future, error = error]() {
+	  complete(future, error);
+	  release(future);
+	});
+  }
+  return result;
+}
+
+void store::register_watches(const commit_request &request, const std::vector<key_range> &writes,
+							 std::vector<std::pair<FDB_future *, fdb_error_t>> &ready) {
+  for (const auto &[key, future] : request.watches) {
+	if (_watches.size() >= std::size_t(request.max_watches)) {
+	  ready.emplace_back(future, error::too_many_watches);
+	  continue;
+	}
+	bool written = std::any_of(writes.begin(), writes.end(), [&key = key](const auto &range) {
+	  return range.contains(key);
+	});
+	// value as seen by the transaction, compared to the latest one to know if the watch is already triggered
+	std::optional<std::string> expected;
+	if (written || !request.read_version) {
+	  expected = latest(key);
+	} else if (auto it = data.find(key); it != data.end()) {
+	  if (const auto *value = visible_at(it->second, *request.read_version)) {
+		expected = *value;
+	  }
+	}
+	if (expected != latest(key)) {
+	  ready.emplace_back(future, error::success);
+	  continue;
+	}
+
+	bool pending = false;
+	{
+	  std::scoped_lock future_lock(future->mutex);
+	  if (!future->ready) {
+		future->on_cancel = [this, key = key, future = future]() { remove_watch(key, future); };
+		pending = true;
+	  }
+	}
+	if (!pending) {
+	  release(future);
+	  continue;
+	}
+	_watches.emplace(key, watch{future, std::move(expected)});
+  }
+}
+
+void store::trigger_watches(const std::vector<key_range> &writes,
+							std::vector<std::pair<FDB_future *, fdb_error_t>> &ready) {
+  if (_watches.empty()) {
+	return;
+  }
+  for (const auto &range : writes) {
+	for (auto it = _watches.lower_bound(range.begin); it != _watches.end() && it->first < range.end;) {
+	  if (latest(it->first) != it->second.expected) {
+		ready.emplace_back(it->second.future, error::success);
+		it = _watches.erase(it);
+	  } else {
+		++it;
+	  }
+	}
+  }
+}
+
+void store::remove_watch(const std::string &key, FDB_future *future) {
+  FDB_future *removed = nullptr;
+  {
+	std::unique_lock lock(mutex);
+	auto [begin, end] = _watches.equal_range(key);
+	for (auto it = begin; it != end; ++it) {
+	  if (it->second.future == future) {
+		removed = future;
+		_watches.erase(it);
+		break;
+	  }
+	}
+  }
+  if (removed) {
+	release(removed);
+  }
+}
+
+std::shared_ptr<store> open_store(const std::string &cluster_file_path) {
+  // stores are never destroyed so that data outlive the databases, like a cluster would
+  static auto *mutex = new std::mutex();
+  static auto *stores = new std::unordered_map<std::string, std::shared_ptr<store>>();
+
+  std::scoped_lock lock(*mutex);
+  auto &opened = (*stores)[cluster_file_path];
+  if (!opened) {
+	opened = std::make_shared<store>();
+  }
+  return opened;
+}
+
+}// namespace ffdb::memory
@@ -0,0 +1,196 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FREE_FDB_BACKEND_MEMORY_STORE_HH
+#define FREE_FDB_BACKEND_MEMORY_STORE_HH
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "future.hh"
+
+namespace ffdb::memory {
+
+//! versions are kept in the store for 5 seconds, like the MVCC window of a FoundationDB cluster
+constexpr std::int64_t mvcc_window = 5'000'000;
+
+//! defaults limits of a FoundationDB cluster
+constexpr std::size_t max_key_size = 10'000;
+constexpr std::size_t max_value_size = 100'000;
+constexpr int default_max_watches = 10'000;
+
+struct key_range {
+  std::string begin;
+  std::string end;
+
+  [[nodiscard]] bool intersects(const key_range &other) const {
+	return begin < other.end && other.begin < end;
+  }
+  [[nodiscard]] bool contains(std::string_view key) const {
+	return begin <= key && key < end;
+  }
+};
+
+/**
+ * @return the key directly following the provided one, useful to make a range containing a single key
+ */
+[[nodiscard]] inline std::string key_after(std::string_view key) {
+  std::string after(key);
+  after.push_back('\0');
+  return after;
+}
+
+enum class mutation_type {
+  set,
+  clear,
+  clear_range,
+  atomic
+};
+
+struct mutation {
+  mutation_type type;
+  std::string key;
+  //! value for set, end of the range for clear_range, operand for atomic
+  std::string param;
+  FDBMutationType op = FDBMutationType::FDB_MUTATION_TYPE_ADD;
+};
+
+/**
+ * Apply an atomic operation over the value currently stored (std::nullopt if the key is not set)
+ * @return the value resulting of the operation, std::nullopt if the key is cleared by the operation
+ */
+[[nodiscard]] std::optional<std::string> apply_atomic(FDBMutationType op, const std::optional<std::string> &current,
+													  std::string_view param);
+
+struct stored_version {
+  std::int64_t version;
+  //! std::nullopt if the key has been cleared at this version
+  std::optional<std::string> value;
+};
+
+using versioned_map = std::map<std::string, std::vector<stored_version>, std::less<>>;
+
+/**
+ * @return the value of the key visible at the read version provided, or nullptr if there is none
+ */
+[[nodiscard]] const std::string *visible_at(const std::vector<stored_version> &versions, std::int64_t read_version);
+
+struct commit_request {
+  //! read version of the transaction, std::nullopt if the transaction didn't get one
+  std::optional<std::int64_t> read_version;
+  const std::vector<mutation> &mutations;
+  const std::vector<key_range> &read_conflicts;
+  const std::vector<key_range> &write_conflicts;
+  //! watches set by the transaction, ownership of the futures is given to the store on success
+  const std::vector<std::pair<std::string, FDB_future *>> &watches;
+  int max_watches;
+};
+
+struct commit_result {
+  fdb_error_t error = 0;
+  //! -1 for read-only transactions
+  std::int64_t version = -1;
+  std::string versionstamp;
+};
+
+/**
+ * Ordered map of keys to their versions over the MVCC window, shared by all the databases opened with the same
+ * cluster file. Readers lock the store in shared mode while committers lock it exclusively, a commit fails with
+ * not_committed if a key read by the transaction has been written by another commit after its read version.
+ */
+class store {
+
+public:
+  store();
+
+  /**
+   * @return version to read at, at least the version of the last commit (equivalent of a GRV request)
+   */
+  [[nodiscard]] std::int64_t read_version();
+
+  /**
+   * @return error to return when reading at the provided version (transaction_too_old / future_version), 0 if valid
+   */
+  [[nodiscard]] fdb_error_t check_read_version(std::int64_t version) const;
+
+  commit_result commit(const commit_request &request);
+
+  //! locked in shared mode to read from the data
+  mutable std::shared_mutex mutex;
+  versioned_map data;
+
+private:
+  struct commit_record {
+	std::int64_t version;
+	std::vector<key_range> writes;
+  };
+
+  struct watch {
+	FDB_future *future;
+	std::optional<std::string> expected;
+  };
+
+  [[nodiscard]] std::int64_t now_version() const;
+  [[nodiscard]] std::int64_t oldest_version() const;
+
+  [[nodiscard]] bool conflicts(const commit_request &request) const;
+
+  void write(const std::string &key, std::optional<std::string> value, std::int64_t version);
+
+  void apply(const mutation &m, std::int64_t version, const std::string &stamp, std::vector<key_range> &writes);
+
+  void register_watches(const commit_request &request, const std::vector<key_range> &writes,
+						std::vector<std::pair<FDB_future *, fdb_error_t>> &ready);
+
+  void trigger_watches(const std::vector<key_range> &writes, std::vector<std::pair<FDB_future *, fdb_error_t>> &ready);
+
+  void remove_watch(const std::string &key, FDB_future *future);
+
+  [[nodiscard]] std::optional<std::string> latest(std::string_view key) const;
+
+  clock::time_point _origin;
+  std::int64_t _committed_version = 0;
+  std::atomic<std::int64_t> _last_read_version{0};
+
+  //! keys written by the commits of the MVCC window, used to detect conflicts
+  std::deque<commit_record> _log;
+
+  std::multimap<std::string, watch, std::less<>> _watches;
+};
+
+/**
+ * @return store associated to the cluster file (created at first use)
+ */
+[[nodiscard]] std::shared_ptr<store> open_store(const std::string &cluster_file_path);
+
+}// namespace ffdb::memory
+
+#endif//FREE_FDB_BACKEND_MEMORY_STORE_HH
@@ -0,0 +1,621 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "error.hh"
+#include "transaction.hh"
+
+namespace {
+
+using namespace ffdb::memory;
+
+constexpr std::string_view system_keys_begin = "\xff";
+constexpr std::string_view system_keys_end = "\xff\xff";
+
+constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+
+/**
+ * Bytes returned by a range read depending on the streaming mode, same values as the FoundationDB client
+ */
+std::size_t byte_limit(const range_options &opt) {
+  static constexpr std::size_t iterator_progression[] = {256, 1000, 4096, 6144, 9216, 13824, 20736, 31104, 46656,
+														 69984, 80000};
+  std::size_t bytes = unlimited;
+  switch (opt.mode) {
+	case FDBStreamingMode::FDB_STREAMING_MODE_ITERATOR:
+	  bytes = iterator_progression[std::clamp(opt.iteration - 1, 0, 10)];
+	  break;
+	case FDBStreamingMode::FDB_STREAMING_MODE_SMALL:
+	  bytes = 256;
+	  break;
+	case FDBStreamingMode::FDB_STREAMING_MODE_MEDIUM:
+	  bytes = 1000;
+	  break;
+	case FDBStreamingMode::FDB_STREAMING_MODE_LARGE:
+	  bytes = 4096;
+	  break;
+	case FDBStreamingMode::FDB_STREAMING_MODE_SERIAL:
+	  bytes = 80000;
+	  break;
+	default:
+	  break;
+  }
+  if (opt.target_bytes > 0) {
+	bytes = std::min(bytes, std::size_t(opt.target_bytes));
+  }
+  return bytes;
+}
+
+/**
+ * Merge the keys of the store and of the mutations of the transaction (both iterated in the same direction), and
+ * return them one by one if they have a value for the transaction.
+ */
+template<typename StoreIt, typename WriteIt, typename Before, typename View>
+class cursor {
+
+public:
+  cursor(StoreIt store_it, StoreIt store_end, WriteIt write_it, WriteIt write_end, Before before, View view,
+		 std::int64_t read_version, bool store_only)
+	  : _store_it(store_it), _store_end(store_end), _write_it(write_it), _write_end(write_end), _before(before),
+		_view(view), _read_version(read_version), _store_only(store_only) {}
+
+  std::optional<FDB_transaction::kv> next() {
+	while (_store_it != _store_end || _write_it != _write_end) {
+	  bool from_store = _write_it == _write_end || (_store_it != _store_end && _before(_store_it->first, _write_it->first));
+	  if (from_store && _store_only) {
+		// key not written by the transaction, its value is the one stored
+		const auto &[key, versions] = *_store_it++;
+		if (const auto *value = visible_at(versions, _read_version)) {
+		  return FDB_transaction::kv{key, *value};
+		}
+		continue;
+	  }
+	  std::string key = from_store ? _store_it->first : _write_it->first;
+	  if (_store_it != _store_end && _store_it->first == key) {
+		++_store_it;
+	  }
+	  if (_write_it != _write_end && _write_it->first == key) {
+		++_write_it;
+	  }
+	  if (auto value = _view(key)) {
+		return FDB_transaction::kv{std::move(key), std::move(*value)};
+	  }
+	}
+	return std::nullopt;
+  }
+
+private:
+  StoreIt _store_it;
+  StoreIt _store_end;
+  WriteIt _write_it;
+  WriteIt _write_end;
+  Before _before;
+  View _view;
+  std::int64_t _read_version;
+  bool _store_only;
+};
+
+fdb_error_t int_option(const std::uint8_t *value, int length, std::int64_t &out) {
+  if (!value || length != sizeof(std::int64_t)) {
+	return error::invalid_option_value;
+  }
+  std::memcpy(&out, value, sizeof(std::int64_t));
+  return error::success;
+}
+
+}// namespace
+
+FDB_transaction::FDB_transaction(std::shared_ptr<store> db, transaction_options defaults, int max_watches)
+	: _store(std::move(db)), _defaults(defaults), _opt(defaults), _max_watches(max_watches), _started(clock::now()) {
+}
+
+FDB_transaction::~FDB_transaction() {
+  fail_pending(error::transaction_cancelled);
+}
+
+fdb_error_t FDB_transaction::set_option(FDBTransactionOption option, const std::uint8_t *value, int length) {
+  switch (option) {
+	case FDBTransactionOption::FDB_TR_OPTION_TIMEOUT:
+	  return int_option(value, length, _opt.timeout);
+	case FDBTransactionOption::FDB_TR_OPTION_RETRY_LIMIT:
+	  return int_option(value, length, _opt.retry_limit);
+	case FDBTransactionOption::FDB_TR_OPTION_MAX_RETRY_DELAY:
+	  return int_option(value, length, _opt.max_retry_delay);
+	case FDBTransactionOption::FDB_TR_OPTION_SIZE_LIMIT:
+	  return int_option(value, length, _opt.size_limit);
+	case FDBTransactionOption::FDB_TR_OPTION_READ_YOUR_WRITES_DISABLE:
+	  _opt.read_your_writes_disable = true;
+	  return error::success;
+	case FDBTransactionOption::FDB_TR_OPTION_READ_SYSTEM_KEYS:
+	  _opt.read_system_keys = true;
+	  return error::success;
+	case FDBTransactionOption::FDB_TR_OPTION_ACCESS_SYSTEM_KEYS:
+	  _opt.access_system_keys = true;
+	  return error::success;
+	default:
+	  // options related to the cluster (priority, causality, durability...) have no effect in memory
+	  return error::success;
+  }
+}
+
+void FDB_transaction::set_read_version(std::int64_t version) {
+  _read_version = version;
+}
+
+bool FDB_transaction::timed_out() const {
+  return _opt.timeout > 0 && clock::now() - _started > std::chrono::milliseconds(_opt.timeout);
+}
+
+std::string_view FDB_transaction::max_key() const {
+  return _opt.read_system_keys || _opt.access_system_keys ? system_keys_end : system_keys_begin;
+}
+
+fdb_error_t FDB_transaction::prepare_read() {
+  if (timed_out()) {
+	return error::transaction_timed_out;
+  }
+  if (!_read_version) {
+	_read_version = _store->read_version();
+  }
+  return error::success;
+}
+
+std::optional<std::string> FDB_transaction::stored(std::string_view key) const {
+  auto it = _store->data.find(key);
+  if (it == _store->data.end()) {
+	return std::nullopt;
+  }
+  if (const auto *value = visible_at(it->second, *_read_version)) {
+	return *value;
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> FDB_transaction::view(std::string_view key) const {
+  auto value = stored(key);
+  if (_opt.read_your_writes_disable || _mutations.empty()) {
+	return value;
+  }
+  std::vector<std::size_t> indexes;
+  if (auto it = _writes.find(key); it != _writes.end()) {
+	indexes = it->second;
+  }
+  bool cleared = false;
+  for (auto index : _clears) {
+	const auto &m = _mutations[index];
+	if (m.key <= key && key < m.param) {
+	  indexes.push_back(index);
+	  cleared = true;
+	}
+  }
+  if (cleared) {
+	std::sort(indexes.begin(), indexes.end());
+  }
+  for (auto index : indexes) {
+	const auto &m = _mutations[index];
+	switch (m.type) {
+	  case mutation_type::set:
+		value = m.param;
+		break;
+	  case mutation_type::clear:
+	  case mutation_type::clear_range:
+		value.reset();
+		break;
+	  case mutation_type::atomic:
+		value = apply_atomic(m.op, value, m.param);
+		break;
+	}
+  }
+  return value;
+}
+
+bool FDB_transaction::has_overlay() const {
+  return !_opt.read_your_writes_disable && !_mutations.empty();
+}
+
+auto FDB_transaction::forward_cursor(std::string_view key, bool inclusive) const {
+  const auto &data = _store->data;
+  auto store_it = inclusive ? data.lower_bound(key) : data.upper_bound(key);
+  auto write_it = !has_overlay() ? _writes.end() : inclusive ? _writes.lower_bound(key) : _writes.upper_bound(key);
+  auto view = [this](const std::string &k) { return this->view(k); };
+  return cursor(store_it, data.end(), write_it, _writes.end(), std::less<>{}, view, *_read_version,
+				!has_overlay() || _clears.empty());
+}
+
+auto FDB_transaction::reverse_cursor(std::string_view key, bool inclusive) const {
+  const auto &data = _store->data;
+  auto store_it = std::make_reverse_iterator(inclusive ? data.upper_bound(key) : data.lower_bound(key));
+  auto write_it = !has_overlay() ? _writes.rend()
+								 : std::make_reverse_iterator(inclusive ? _writes.upper_bound(key) : _writes.lower_bound(key));
+  auto view = [this](const std::string &k) { return this->view(k); };
+  return cursor(store_it, data.rend(), write_it, _writes.rend(), std::greater<>{}, view, *_read_version,
+				!has_overlay() || _clears.empty());
+}
+
+std::optional<FDB_transaction::kv> FDB_transaction::next_visible(std::string_view key, bool inclusive) const {
+  return forward_cursor(key, inclusive).next();
+}
+
+std::optional<FDB_transaction::kv> FDB_transaction::prev_visible(std::string_view key, bool inclusive) const {
+  return reverse_cursor(key, inclusive).next();
+}
+
+std::string FDB_transaction::resolve(const key_selector &selector) const {
+  auto max = max_key();
+  std::optional<kv> position;
+  if (selector.offset >= 1) {
+	// offset 1 from the last key lesser than the key is the first key greater or equal to it
+	position = next_visible(selector.key, !selector.or_equal);
+	for (int i = 1; i < selector.offset && position; ++i) {
+	  position = next_visible(position->first, false);
+	}
+	if (!position || position->first >= max) {
+	  return std::string(max);
+	}
+	return std::move(position->first);
+  }
+  position = prev_visible(selector.key, selector.or_equal);
+  for (int i = 0; i < -selector.offset && position; ++i) {
+	position = prev_visible(position->first, false);
+  }
+  if (!position) {
+	return {};
+  }
+  return position->first < max ? std::move(position->first) : std::string(max);
+}
+
+FDB_future *FDB_transaction::get_read_version() {
+  if (auto error = prepare_read(); error) {
+	return make_error_future(error);
+  }
+  auto *future = make_future();
+  future->version = *_read_version;
+  complete(future);
+  return future;
+}
+
+FDB_future *FDB_transaction::get(std::string_view key, bool snapshot) {
+  if (auto error = prepare_read(); error) {
+	return make_error_future(error);
+  }
+  if (key >= max_key()) {
+	return make_error_future(error::key_outside_legal_range);
+  }
+  auto *future = make_future();
+  {
+	std::shared_lock lock(_store->mutex);
+	if (auto error = _store->check_read_version(*_read_version); error) {
+	  complete(future, error);
+	  return future;
+	}
+	future->value = view(key);
+  }
+  if (!snapshot) {
+	_read_conflicts.push_back({std::string(key), key_after(key)});
+  }
+  complete(future);
+  return future;
+}
+
+FDB_future *FDB_transaction::get_key(key_selector selector, bool snapshot) {
+  if (auto error = prepare_read(); error) {
+	return make_error_future(error);
+  }
+  auto *future = make_future();
+  {
+	std::shared_lock lock(_store->mutex);
+	if (auto error = _store->check_read_version(*_read_version); error) {
+	  complete(future, error);
+	  return future;
+	}
+	future->key = resolve(selector);
+  }
+  if (!snapshot) {
+	auto [begin, end] = std::minmax(std::string(selector.key), future->key);
+	_read_conflicts.push_back({begin, key_after(end)});
+  }
+  complete(future);
+  return future;
+}
+
+FDB_future *FDB_transaction::get_range(key_selector begin, key_selector end, const range_options &opt) {
+  if (auto error = prepare_read(); error) {
+	return make_error_future(error);
+  }
+  auto *future = make_future();
+  std::string begin_key;
+  std::string end_key;
+  {
+	std::shared_lock lock(_store->mutex);
+	if (auto error = _store->check_read_version(*_read_version); error) {
+	  complete(future, error);
+	  return future;
+	}
+	begin_key = resolve(begin);
+	end_key = resolve(end);
+
+	std::size_t row_limit = opt.limit > 0 ? std::size_t(opt.limit) : unlimited;
+	std::size_t bytes_limit = byte_limit(opt);
+	std::size_t bytes = 0;
+	auto &rows = future->rows;
+
+	auto in_range = [&](const kv &row) {
+	  return opt.reverse ? begin_key <= row.first : row.first < end_key;
+	};
+	auto scan = [&](auto rows_cursor) {
+	  for (auto row = rows_cursor.next(); row && in_range(*row); row = rows_cursor.next()) {
+		if (rows.size() >= row_limit || bytes >= bytes_limit) {
+		  future->more = true;
+		  break;
+		}
+		bytes += row->first.size() + row->second.size();
+		rows.push_back(std::move(*row));
+	  }
+	};
+	if (begin_key < end_key) {
+	  if (opt.reverse) {
+		scan(reverse_cursor(end_key, false));
+	  } else {
+		scan(forward_cursor(begin_key, true));
+	  }
+	}
+  }
+
+  if (!opt.snapshot && begin_key < end_key) {
+	// only the part of the range actually read conflicts
+	if (!future->more) {
+	  _read_conflicts.push_back({std::move(begin_key), std::move(end_key)});
+	} else if (opt.reverse) {
+	  _read_conflicts.push_back({future->rows.back().first, std::move(end_key)});
+	} else {
+	  _read_conflicts.push_back({std::move(begin_key), key_after(future->rows.back().first)});
+	}
+  }
+
+  future->kv.reserve(future->rows.size());
+  for (const auto &[key, value] : future->rows) {
+	future->kv.push_back(FDBKeyValue{key.data(), int(key.size()), value.data(), int(value.size())});
+  }
+  complete(future);
+  return future;
+}
+
+void FDB_transaction::defer(fdb_error_t error) {
+  if (!_deferred_error) {
+	_deferred_error = error;
+  }
+}
+
+void FDB_transaction::add_mutation(mutation m, bool readable) {
+  _size += m.key.size() + m.param.size();
+  auto index = _mutations.size();
+  if (m.type == mutation_type::clear_range) {
+	_clears.push_back(index);
+  } else if (readable) {
+	_writes[m.key].push_back(index);
+  }
+  _mutations.push_back(std::move(m));
+}
+
+void FDB_transaction::set(std::string_view key, std::string_view value) {
+  if (key.size() > max_key_size) {
+	return defer(error::key_too_large);
+  }
+  if (value.size() > max_value_size) {
+	return defer(error::value_too_large);
+  }
+  if (!_opt.access_system_keys && key >= system_keys_begin) {
+	return defer(error::key_outside_legal_range);
+  }
+  add_mutation({mutation_type::set, std::string(key), std::string(value)});
+}
+
+void FDB_transaction::clear(std::string_view key) {
+  if (!_opt.access_system_keys && key >= system_keys_begin) {
+	return defer(error::key_outside_legal_range);
+  }
+  add_mutation({mutation_type::clear, std::string(key), {}});
+}
+
+void FDB_transaction::clear_range(std::string_view begin, std::string_view end) {
+  if (begin > end) {
+	return defer(error::inverted_range);
+  }
+  if (end > (_opt.access_system_keys ? system_keys_end : system_keys_begin)) {
+	return defer(error::key_outside_legal_range);
+  }
+  if (begin == end) {
+	return;
+  }
+  add_mutation({mutation_type::clear_range, std::string(begin), std::string(end)});
+}
+
+void FDB_transaction::atomic_op(std::string_view key, std::string_view param, FDBMutationType op) {
+  if (!_opt.access_system_keys && key >= system_keys_begin) {
+	return defer(error::key_outside_legal_range);
+  }
+  if (param.size() > max_value_size) {
+	return defer(error::value_too_large);
+  }
+  // versionstamped mutations are written at commit time, they can't be read before
+  bool versionstamped = op == FDBMutationType::FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_KEY
+	  || op == FDBMutationType::FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_VALUE;
+  if (versionstamped) {
+	auto incomplete = op == FDBMutationType::FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_KEY ? key : param;
+	std::uint32_t offset = 0;
+	if (incomplete.size() >= 4) {
+	  std::memcpy(&offset, incomplete.data() + incomplete.size() - 4, sizeof(offset));
+	}
+	if (incomplete.size() < 4 || std::size_t(offset) + 10 > incomplete.size() - 4) {
+	  return defer(error::client_invalid_operation);
+	}
+  }
+  add_mutation({mutation_type::atomic, std::string(key), std::string(param), op}, !versionstamped);
+}
+
+fdb_error_t FDB_transaction::add_conflict_range(std::string_view begin, std::string_view end,
+												FDBConflictRangeType type) {
+  if (begin > end) {
+	return error::inverted_range;
+  }
+  if (begin == end) {
+	return error::success;
+  }
+  _size += begin.size() + end.size();
+  auto &ranges = type == FDBConflictRangeType::FDB_CONFLICT_RANGE_TYPE_READ ? _read_conflicts : _write_conflicts;
+  ranges.push_back({std::string(begin), std::string(end)});
+  return error::success;
+}
+
+FDB_future *FDB_transaction::watch(std::string_view key) {
+  if (timed_out()) {
+	return make_error_future(error::transaction_timed_out);
+  }
+  if (key >= max_key()) {
+	return make_error_future(error::key_outside_legal_range);
+  }
+  // the watch is set when the transaction is committed
+  auto *future = make_future();
+  reference(future);
+  _watches.emplace_back(std::string(key), future);
+  return future;
+}
+
+FDB_future *FDB_transaction::commit() {
+  if (_committed) {
+	return make_error_future(error::client_invalid_operation);
+  }
+  fdb_error_t error = timed_out() ? error::transaction_timed_out : _deferred_error;
+  if (!error && _opt.size_limit > 0 && _size > std::size_t(_opt.size_limit)) {
+	error = error::transaction_too_large;
+  }
+  if (!error) {
+	auto result = _store->commit(
+		commit_request{_read_version, _mutations, _read_conflicts, _write_conflicts, _watches, _max_watches});
+	error = result.error;
+	if (!error) {
+	  _committed = true;
+	  _committed_version = result.version;
+	  _versionstamp = std::move(result.versionstamp);
+	  // watches are now owned by the store
+	  _watches.clear();
+	}
+  }
+  if (error) {
+	fail_pending(error);
+	return make_error_future(error);
+  }
+  for (auto *future : _versionstamps) {
+	future->key = _versionstamp;
+	complete(future, _committed_version < 0 ? error::no_commit_version : error::success);
+	release(future);
+  }
+  _versionstamps.clear();
+  return make_error_future(error::success);
+}
+
+fdb_error_t FDB_transaction::get_committed_version(std::int64_t *version) const {
+  *version = _committed_version;
+  return error::success;
+}
+
+FDB_future *FDB_transaction::get_versionstamp() {
+  auto *future = make_future();
+  if (_committed) {
+	future->key = _versionstamp;
+	complete(future, _committed_version < 0 ? error::no_commit_version : error::success);
+	return future;
+  }
+  reference(future);
+  _versionstamps.push_back(future);
+  return future;
+}
+
+FDB_future *FDB_transaction::on_error(fdb_error_t error) {
+  if (!error::is_retryable(error) || (_opt.retry_limit >= 0 && _retries >= _opt.retry_limit)) {
+	return make_error_future(error);
+  }
+  if (timed_out()) {
+	return make_error_future(error::transaction_timed_out);
+  }
+  // exponential backoff, starting lower than the client library as there is no cluster to wait for
+  auto delay = std::chrono::milliseconds(std::min<std::int64_t>(std::int64_t(1) << std::min(_retries, 20),
+																 _opt.max_retry_delay));
+  ++_retries;
+  reset(true);
+
+  auto *future = make_future();
+  reference(future);
+  post(
+	  [future]() {
+		complete(future);
+		release(future);
+	  },
+	  delay);
+  return future;
+}
+
+void FDB_transaction::fail_pending(fdb_error_t error) {
+  for (auto &[key, future] : _watches) {
+	complete(future, error);
+	release(future);
+  }
+  _watches.clear();
+  for (auto *future : _versionstamps) {
+	complete(future, error);
+	release(future);
+  }
+  _versionstamps.clear();
+}
+
+void FDB_transaction::reset(bool retry) {
+  fail_pending(error::transaction_cancelled);
+  _read_version.reset();
+  _deferred_error = 0;
+  _size = 0;
+  _mutations.clear();
+  _writes.clear();
+  _clears.clear();
+  _read_conflicts.clear();
+  _write_conflicts.clear();
+  _committed = false;
+  _committed_version = -1;
+  _versionstamp.clear();
+  if (!retry) {
+	_opt = _defaults;
+	_retries = 0;
+	_started = clock::now();
+	return;
+  }
+  // as the real client, only the timeout, retry limit, max retry delay and size limit are kept on retry
+  transaction_options kept = _defaults;
+  kept.timeout = _opt.timeout;
+  kept.retry_limit = _opt.retry_limit;
+  kept.max_retry_delay = _opt.max_retry_delay;
+  kept.size_limit = _opt.size_limit;
+  _opt = kept;
+}
@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FREE_FDB_BACKEND_MEMORY_TRANSACTION_HH
+#define FREE_FDB_BACKEND_MEMORY_TRANSACTION_HH
+
+#include "store.hh"
+
+namespace ffdb::memory {
+
+struct transaction_options {
+  //! in milliseconds, 0 for no timeout
+  std::int64_t timeout = 0;
+  //! -1 for no limit
+  std::int64_t retry_limit = -1;
+  //! in milliseconds
+  std::int64_t max_retry_delay = 1000;
+  //! in bytes
+  std::int64_t size_limit = 10'000'000;
+
+  bool read_your_writes_disable = false;
+  bool read_system_keys = false;
+  bool access_system_keys = false;
+};
+
+/**
+ * Selector of a key as defined by FoundationDB: the key at offset of the last key lesser than the key (or lesser or
+ * equal if or_equal is set)
+ * @see https://apple.github.io/foundationdb/developer-guide.html#key-selectors
+ */
+struct key_selector {
+  std::string_view key;
+  bool or_equal;
+  int offset;
+};
+
+struct range_options {
+  int limit;
+  int target_bytes;
+  FDBStreamingMode mode;
+  int iteration;
+  bool snapshot;
+  bool reverse;
+};
+
+}// namespace ffdb::memory
+
+/**
+ * Transaction of the in-memory backend, reads are done on the store at the read version of the transaction and merged
+ * with the mutations of the transaction (read your writes). Mutations are kept in order and applied on commit.
+ */
+struct FDB_transaction {
+
+  using kv = std::pair<std::string, std::string>;
+
+  FDB_transaction(std::shared_ptr<ffdb::memory::store> db, ffdb::memory::transaction_options defaults,
+				  int max_watches);
+  ~FDB_transaction();
+
+  fdb_error_t set_option(FDBTransactionOption option, const std::uint8_t *value, int length);
+  void set_read_version(std::int64_t version);
+
+  FDB_future *get_read_version();
+  FDB_future *get(std::string_view key, bool snapshot);
+  FDB_future *get_key(ffdb::memory::key_selector selector, bool snapshot);
+  FDB_future *get_range(ffdb::memory::key_selector begin, ffdb::memory::key_selector end,
+						const ffdb::memory::range_options &opt);
+
+  void set(std::string_view key, std::string_view value);
+  void clear(std::string_view key);
+  void clear_range(std::string_view begin, std::string_view end);
+  void atomic_op(std::string_view key, std::string_view param, FDBMutationType op);
+  fdb_error_t add_conflict_range(std::string_view begin, std::string_view end, FDBConflictRangeType type);
+
+  FDB_future *watch(std::string_view key);
+  FDB_future *commit();
+  fdb_error_t get_committed_version(std::int64_t *version) const;
+  FDB_future *get_versionstamp();
+  FDB_future *on_error(fdb_error_t error);
+
+  /**
+   * Reset the transaction to its initial state, the retry count, the start time (for timeout) and the persistent
+   * options (timeout, retry limit, max retry delay and size limit) are kept only if the reset is due to a retry
+   */
+  void reset(bool retry = false);
+
+private:
+  /**
+   * Get a read version if none is set, and check it can be read at
+   * @return error preventing the transaction to read, 0 if none
+   */
+  fdb_error_t prepare_read();
+
+  [[nodiscard]] bool timed_out() const;
+
+  [[nodiscard]] std::string_view max_key() const;
+
+  // to call with the store locked in shared mode
+  [[nodiscard]] std::optional<std::string> stored(std::string_view key) const;
+  [[nodiscard]] std::optional<std::string> view(std::string_view key) const;
+  [[nodiscard]] bool has_overlay() const;
+  [[nodiscard]] auto forward_cursor(std::string_view key, bool inclusive) const;
+  [[nodiscard]] auto reverse_cursor(std::string_view key, bool inclusive) const;
+  [[nodiscard]] std::optional<kv> next_visible(std::string_view key, bool inclusive) const;
+  [[nodiscard]] std::optional<kv> prev_visible(std::string_view key, bool inclusive) const;
+  [[nodiscard]] std::string resolve(const ffdb::memory::key_selector &selector) const;
+
+  void add_mutation(ffdb::memory::mutation m, bool readable = true);
+  void defer(fdb_error_t error);
+
+  void fail_pending(fdb_error_t error);
+
+  std::shared_ptr<ffdb::memory::store> _store;
+  ffdb::memory::transaction_options _defaults;
+  ffdb::memory::transaction_options _opt;
+  int _max_watches;
+
+  ffdb::memory::clock::time_point _started;
+  int _retries = 0;
+
+  std::optional<std::int64_t> _read_version;
+  //! error that occurred while registering a mutation, returned on commit
+  fdb_error_t _deferred_error = 0;
+  std::size_t _size = 0;
+
+  std::vector<ffdb::memory::mutation> _mutations;
+  //! indexes in _mutations of the mutations readable by key (set, clear, atomic operations)
+  std::map<std::string, std::vector<std::size_t>, std::less<>> _writes;
+  //! indexes in _mutations of the range clears
+  std::vector<std::size_t> _clears;
+
+  std::vector<ffdb::memory::key_range> _read_conflicts;
+  std::vector<ffdb::memory::key_range> _write_conflicts;
+
+  std::vector<std::pair<std::string, FDB_future *>> _watches;
+  std::vector<FDB_future *> _versionstamps;
+
+  bool _committed = false;
+  std::int64_t _committed_version = -1;
+  std::string _versionstamp;
+};
+
+#endif//FREE_FDB_BACKEND_MEMORY_TRANSACTION_HH
@@ -0,0 +1,413 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../include/free_fdb/ffdb.hh"
+#include "../include/free_fdb/metrics.hh"
+#include "../include/free_fdb/write_batcher.hh"
+
+#ifndef FFDB_BENCH_CLUSTER_FILE
+#define FFDB_BENCH_CLUSTER_FILE "fdb.cluster"
+#endif
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using ffdb::metrics::histogram;
+
+constexpr std::string_view key_prefix = "BENCH/";
+constexpr std::string_view counter_key = "BENCH_COUNTER";
+
+struct bench_options {
+  std::string cluster_file = FFDB_BENCH_CLUSTER_FILE;
+  std::vector<std::string> workloads{};
+  unsigned threads = 8;
+  std::chrono::seconds duration{10};
+  std::size_t keys = 100000;
+  std::size_t value_size = 100;
+  std::size_t scan_size = 100;
+  //! ratio of reads of the mixed workload
+  double read_ratio = 0.95;
+  bool zipfian = false;
+  //! number of writes in flight per thread for the batch workload
+  std::size_t window = 256;
+};
+
+void usage() {
+  std::cerr << "usage: ffdb_bench [options]\n"
+			   "  --cluster-file <path>   cluster file of the database (default: test/fdb.cluster)\n"
+			   "  --workload <name>       workload to run, can be repeated (default: all)\n"
+			   "                          get, put, mixed, range, iterator, counter, batch\n"
+			   "  --threads <n>           number of client threads (default: 8)\n"
+			   "  --duration <s>          duration of each workload in seconds (default: 10)\n"
+			   "  --keys <n>              number of keys loaded before the workloads (default: 100000)\n"
+			   "  --value-size <n>        size of the values in bytes (default: 100)\n"
+			   "  --scan-size <n>         number of keys read by a range scan (default: 100)\n"
+			   "  --read-ratio <r>        ratio of reads of the mixed workload (default: 0.95)\n"
+			   "  --zipfian               skewed key selection (zipfian, theta 0.99) instead of uniform\n"
+			   "  --window <n>            writes in flight per thread for the batch workload (default: 256)\n";
+}
+
+/**
+ * Zipfian key distribution, as generated by YCSB (Gray et al., Quickly Generating Billion-Record Synthetic Databases)
+ */
+class zipfian_distribution {
+public:
+  explicit zipfian_distribution(std::size_t n, double theta = 0.99) : _n(n), _theta(theta) {
+	_zetan = zeta(n);
+	const double zeta2 = zeta(2);
+	_alpha = 1.0 / (1.0 - theta);
+	_eta = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta2 / _zetan);
+  }
+
+  template<typename Generator>
+  std::size_t operator()(Generator &generator) const {
+	const double u = std::uniform_real_distribution<double>(0.0, 1.0)(generator);
+	const double uz = u * _zetan;
+	if (uz < 1.0) {
+	  return 0;
+	}
+	if (uz < 1.0 + std::pow(0.5, _theta)) {
+	  return 1;
+	}
+	const auto value = static_cast<std::size_t>(static_cast<double>(_n) * std::pow(_eta * u - _eta + 1.0, _alpha));
+	return std::min(value, _n - 1);
+  }
+
+private:
+  [[nodiscard]] double zeta(std::size_t n) const {
+	double sum = 0;
+	for (std::size_t i = 1; i <= n; ++i) {
+	  sum += 1.0 / std::pow(static_cast<double>(i), _theta);
+	}
+	return sum;
+  }
+
+  std::size_t _n;
+  double _theta;
+  double _zetan;
+  double _alpha;
+  double _eta;
+};
+
+std::string make_key(std::size_t index) {
+  return fmt::format("{}{:010}", key_prefix, index);
+}
+
+/**
+ * State of a client thread: random key selection and latency of its operations
+ */
+struct worker {
+  worker(const bench_options &opt, const zipfian_distribution *zipf, unsigned seed)
+	  : opt(opt), zipf(zipf), generator(seed), value(opt.value_size, 'v') {}
+
+  std::size_t next_index() {
+	if (zipf) {
+	  return (*zipf)(generator);
+	}
+	return std::uniform_int_distribution<std::size_t>(0, opt.keys - 1)(generator);
+  }
+
+  std::string next_key() {
+	return make_key(next_index());
+  }
+
+  bool next_is_read() {
+	return std::uniform_real_distribution<double>(0.0, 1.0)(generator) < opt.read_ratio;
+  }
+
+  const bench_options &opt;
+  const zipfian_distribution *zipf;
+  std::mt19937_64 generator;
+  std::string value;
+  histogram latencies;
+};
+
+using operation = std::function<void(ffdb::free_fdb &, worker &)>;
+
+void get(ffdb::free_fdb &db, worker &w) {
+  auto trans = db.acquire_transaction();
+  static_cast<void>(trans->get_view(w.next_key()));
+}
+
+void put(ffdb::free_fdb &db, worker &w) {
+  const std::string key = w.next_key();
+  db.run([&](ffdb::fdb_transaction &trans) { trans.put(key, w.value); });
+}
+
+void mixed(ffdb::free_fdb &db, worker &w) {
+  if (w.next_is_read()) {
+	get(db, w);
+  } else {
+	put(db, w);
+  }
+}
+
+void range(ffdb::free_fdb &db, worker &w) {
+  const std::size_t first = std::min(w.next_index(), w.opt.keys - std::min(w.opt.keys, w.opt.scan_size));
+  ffdb::range_options opt;
+  opt.limit = static_cast<int>(w.opt.scan_size);
+  auto trans = db.acquire_transaction();
+  static_cast<void>(trans->get_range_view(make_key(first), make_key(w.opt.keys), opt));
+}
+
+void iterate(ffdb::free_fdb &db, worker &w) {
+  const std::size_t first = std::min(w.next_index(), w.opt.keys - std::min(w.opt.keys, w.opt.scan_size));
+  ffdb::it_options opt;
+  opt.iterate_lower_bound = make_key(first);
+  opt.iterate_upper_bound = make_key(w.opt.keys);
+  opt.limit = static_cast<int>(w.opt.scan_size);
+  auto it = db.make_iterator(opt);
+  for (it.seek_first(); it.is_valid(); it.next()) {
+  }
+}
+
+void increment(ffdb::free_fdb &db, worker &) {
+  static const ffdb::fdb_counter counter(counter_key);
+  db.run([](ffdb::fdb_transaction &trans) { counter.add(trans); });
+}
+
+/**
+ * Run the operation on all the threads for the duration of the workload
+ * @return latency of all the operations
+ */
+histogram run_workload(ffdb::free_fdb &db, const bench_options &opt, const zipfian_distribution *zipf, const operation &op) {
+  std::vector<worker> workers;
+  workers.reserve(opt.threads);
+  for (unsigned i = 0; i < opt.threads; ++i) {
+	workers.emplace_back(opt, zipf, i + 1);
+  }
+
+  const auto deadline = clock_type::now() + opt.duration;
+  std::vector<std::thread> threads;
+  for (auto &w : workers) {
+	threads.emplace_back([&db, &op, &w, deadline]() {
+	  while (clock_type::now() < deadline) {
+		const auto start = clock_type::now();
+		op(db, w);
+		w.latencies.record(clock_type::now() - start);
+	  }
+	});
+  }
+  for (auto &t : threads) {
+	t.join();
+  }
+
+  histogram total;
+  for (const auto &w : workers) {
+	total.merge(w.latencies);
+  }
+  return total;
+}
+
+/**
+ * Writes through a write_batcher, each thread keeps a window of writes in flight. The latency of a write is measured
+ * up to the commit of its batch.
+ */
+histogram run_batch_workload(ffdb::free_fdb &db, const bench_options &opt, const zipfian_distribution *zipf) {
+  ffdb::write_batcher batcher(db);
+  std::vector<worker> workers;
+  workers.reserve(opt.threads);
+  for (unsigned i = 0; i < opt.threads; ++i) {
+	workers.emplace_back(opt, zipf, i + 1);
+  }
+
+  const auto deadline = clock_type::now() + opt.duration;
+  std::vector<std::thread> threads;
+  for (auto &w : workers) {
+	threads.emplace_back([&batcher, &w, &opt, deadline]() {
+	  std::deque<std::pair<clock_type::time_point, std::future<void>>> in_flight;
+	  auto complete_oldest = [&]() {
+		in_flight.front().second.get();
+		w.latencies.record(clock_type::now() - in_flight.front().first);
+		in_flight.pop_front();
+	  };
+	  while (clock_type::now() < deadline) {
+		in_flight.emplace_back(clock_type::now(), batcher.put(w.next_key(), w.value));
+		if (in_flight.size() >= opt.window) {
+		  complete_oldest();
+		}
+	  }
+	  while (!in_flight.empty()) {
+		complete_oldest();
+	  }
+	});
+  }
+  for (auto &t : threads) {
+	t.join();
+  }
+
+  histogram total;
+  for (const auto &w : workers) {
+	total.merge(w.latencies);
+  }
+  return total;
+}
+
+void load(ffdb::free_fdb &db, const bench_options &opt) {
+  const std::string value(opt.value_size, 'v');
+  constexpr std::size_t keys_per_transaction = 1000;
+  for (std::size_t first = 0; first < opt.keys; first += keys_per_transaction) {
+	db.run([&](ffdb::fdb_transaction &trans) {
+	  for (std::size_t i = first; i < std::min(first + keys_per_transaction, opt.keys); ++i) {
+		trans.put(make_key(i), value);
+	  }
+	});
+  }
+}
+
+void clear(ffdb::free_fdb &db) {
+  db.run([](ffdb::fdb_transaction &trans) {
+	trans.del_range(key_prefix, "BENCH0");
+	trans.del(counter_key);
+  });
+}
+
+double to_us(std::chrono::nanoseconds latency) {
+  return std::chrono::duration<double, std::micro>(latency).count();
+}
+
+void report(std::string_view workload, const histogram &latencies, const ffdb::metrics::snapshot &metrics, std::chrono::duration<double> elapsed) {
+  fmt::print("{:<9} {:>10} ops {:>11.0f} ops/s   p50 {:>9.1f}us   p99 {:>9.1f}us   p999 {:>9.1f}us   max {:>9.1f}us   retries {}\n",
+			 workload, latencies.count(), static_cast<double>(latencies.count()) / elapsed.count(),
+			 to_us(latencies.percentile(50)), to_us(latencies.percentile(99)), to_us(latencies.percentile(99.9)),
+			 to_us(latencies.max()), metrics.value(ffdb::metrics::counter::retries));
+}
+
+bench_options parse(int argc, char **argv) {
+  bench_options opt;
+  for (int i = 1; i < argc; ++i) {
+	std::string_view arg = argv[i];
+	auto next = [&]() -> std::string {
+	  if (i + 1 >= argc) {
+		throw std::invalid_argument(fmt::format("missing value for {}", arg));
+	  }
+	  return argv[++i];
+	};
+	if (arg == "--cluster-file") {
+	  opt.cluster_file = next();
+	} else if (arg == "--workload") {
+	  opt.workloads.emplace_back(next());
+	} else if (arg == "--threads") {
+	  opt.threads = static_cast<unsigned>(std::stoul(next()));
+	} else if (arg == "--duration") {
+	  opt.duration = std::chrono::seconds(std::stoul(next()));
+	} else if (arg == "--keys") {
+	  opt.keys = std::stoull(next());
+	} else if (arg == "--value-size") {
+	  opt.value_size = std::stoull(next());
+	} else if (arg == "--scan-size") {
+	  opt.scan_size = std::stoull(next());
+	} else if (arg == "--read-ratio") {
+	  opt.read_ratio = std::stod(next());
+	} else if (arg == "--zipfian") {
+	  opt.zipfian = true;
+	} else if (arg == "--window") {
+	  opt.window = std::max<std::size_t>(std::stoull(next()), 1);
+	} else {
+	  throw std::invalid_argument(fmt::format("unknown option {}", arg));
+	}
+  }
+  if (opt.keys == 0 || opt.threads == 0) {
+	throw std::invalid_argument("--keys and --threads have to be positive");
+  }
+  if (opt.workloads.empty()) {
+	opt.workloads = {"get", "put", "mixed", "range", "iterator", "counter", "batch"};
+  }
+  return opt;
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+  bench_options opt;
+  try {
+	opt = parse(argc, argv);
+  } catch (const std::exception &e) {
+	std::cerr << "ffdb_bench: " << e.what() << "\n";
+	usage();
+	return EXIT_FAILURE;
+  }
+
+  try {
+	ffdb::free_fdb db(opt.cluster_file);
+	std::optional<zipfian_distribution> zipf;
+	if (opt.zipfian) {
+	  zipf.emplace(opt.keys);
+	}
+	const zipfian_distribution *distribution = zipf ? &*zipf : nullptr;
+
+	fmt::print("loading {} keys of {} bytes...\n", opt.keys, opt.value_size);
+	clear(db);
+	load(db, opt);
+
+	fmt::print("{} threads, {}s per workload, {} key selection\n", opt.threads, opt.duration.count(), opt.zipfian ? "zipfian" : "uniform");
+	for (const auto &workload : opt.workloads) {
+	  const auto before = ffdb::metrics::take_snapshot();
+	  const auto start = clock_type::now();
+	  histogram latencies;
+	  if (workload == "get") {
+		latencies = run_workload(db, opt, distribution, get);
+	  } else if (workload == "put") {
+		latencies = run_workload(db, opt, distribution, put);
+	  } else if (workload == "mixed") {
+		latencies = run_workload(db, opt, distribution, mixed);
+	  } else if (workload == "range") {
+		latencies = run_workload(db, opt, distribution, range);
+	  } else if (workload == "iterator") {
+		latencies = run_workload(db, opt, distribution, iterate);
+	  } else if (workload == "counter") {
+		latencies = run_workload(db, opt, distribution, increment);
+	  } else if (workload == "batch") {
+		latencies = run_batch_workload(db, opt, distribution);
+	  } else {
+		std::cerr << "ffdb_bench: unknown workload " << workload << "\n";
+		continue;
+	  }
+	  const std::chrono::duration<double> elapsed = clock_type::now() - start;
+	  report(workload, latencies, ffdb::metrics::take_snapshot().since(before), elapsed);
+	}
+	clear(db);
+  } catch (const std::exception &e) {
+	std::cerr << "ffdb_bench: " << e.what() << "\n";
+	return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
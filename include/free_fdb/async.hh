@@ -0,0 +1,152 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_ASYNC_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_ASYNC_HH
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#ifndef FDB_API_VERSION
+#define FDB_API_VERSION 610
+#endif
+#include <foundationdb/fdb_c.h>
+
+namespace ffdb {
+
+/**
+ * @brief Shared ownership over a FDBFuture, the future is destroyed when the last handle is released
+ */
+using future_handle = std::shared_ptr<FDBFuture>;
+
+/**
+ * @brief Non-template part of the asynchronous result, encapsulate the FDBFuture and the C API calls made on it
+ */
+class fdb_async_base {
+
+public:
+  /**
+   * @return true if the result is available (get() won't block), false otherwise
+   */
+  [[nodiscard]] bool is_ready() const;
+
+  /**
+   * @brief Cancel the underlying operation, a continuation already registered is called with an operation_cancelled
+   * error.
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_future_cancel
+   */
+  void cancel();
+
+protected:
+  explicit fdb_async_base(FDBFuture *future);
+  explicit fdb_async_base(future_handle future) : _future(std::move(future)) {}
+
+  /**
+   * @brief Block until the future is ready
+   * @throw fdb_exception (or transaction_exception if retry-able) if the future is in error
+   */
+  void wait() const;
+
+  /**
+   * @brief Register a callback called as soon as the future is ready.
+   * The callback is executed by the network thread, or directly by the calling thread if the future is already ready.
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_future_set_callback
+   */
+  void on_ready(std::function<void()> callback) const;
+
+  future_handle _future;
+};
+
+/**
+ * @brief Result of an asynchronous foundationdb operation (see fdb_transaction::get_async, fdb_transaction::commit_async)
+ *
+ * The result can be retrieved in a blocking way with get(), or a continuation can be registered with then() in order
+ * to be notified when the result is available without blocking the calling thread.
+ * Copies share the same underlying future.
+ *
+ * @warning the transaction which made the asynchronous call has to outlive it.
+ * @tparam T type of the result retrieved from the future
+ */
+template<typename T>
+class fdb_async : public fdb_async_base {
+
+public:
+  using value_type = T;
+  using extractor = std::function<T(const future_handle &)>;
+
+  fdb_async(FDBFuture *future, extractor extract) : fdb_async_base(future), _extract(std::move(extract)) {
+  }
+
+  fdb_async(future_handle future, extractor extract) : fdb_async_base(std::move(future)), _extract(std::move(extract)) {
+  }
+
+  /**
+   * @brief Retrieve the result of the operation, block the calling thread until the result is available
+   * @throw fdb_exception (or transaction_exception if retry-able) if the operation failed
+   */
+  T get() const {
+	wait();
+	return _extract(_future);
+  }
+
+  /**
+   * @brief Register a continuation called when the result is available, get() can be called from the continuation
+   * without blocking (and throw if the operation failed).
+   *
+   * @warning the continuation is executed on the foundationdb network thread (or directly on the calling thread if the
+   * result is already available), it must not block. Exceptions thrown by the continuation are discarded.
+   *
+   * @param continuation callable with the signature void(const fdb_async<T> &)
+   */
+  template<typename Continuation>
+  void then(Continuation &&continuation) const {
+	on_ready([self = *this, continuation = std::forward<Continuation>(continuation)]() mutable {
+	  continuation(std::as_const(self));
+	});
+  }
+
+  /**
+   * @brief Make an asynchronous result on the same future, its result being converted by the provided function
+   * @param function callable with the signature U(T)
+   * @return asynchronous result of type U
+   */
+  template<typename Function>
+  auto map(Function &&function) const -> fdb_async<std::invoke_result_t<Function, T>> {
+	return fdb_async<std::invoke_result_t<Function, T>>(
+		_future,
+		[extract = _extract, function = std::forward<Function>(function)](const future_handle &f) {
+		  return function(extract(f));
+		});
+  }
+
+private:
+  extractor _extract;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_ASYNC_HH
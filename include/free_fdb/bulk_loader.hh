@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_BULK_LOADER_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_BULK_LOADER_HH
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ffdb.hh"
+#include "subspace.hh"
+
+namespace ffdb {
+
+/**
+ * @brief Options of a bulk load (used by bulk_loader)
+ */
+struct load_options {
+  //! number of threads committing transactions concurrently
+  unsigned concurrency = std::max(1u, std::thread::hardware_concurrency());
+  //! number of partitions the input is split into (taken by the threads one after the other), if set to 0, four
+  //! partitions per thread are made
+  std::size_t partitions = 0;
+  //! estimated size of the transactions, key/values plus the overhead counted by foundationdb (write conflict ranges
+  //! and mutation headers), the transaction limit being 10MB, it is capped at 9MB
+  std::size_t max_batch_bytes = 2 * 1024 * 1024;
+
+  //! if fixed_key_size is set, the input is made of fixed size records (key followed by value, the value size can be 0)
+  //! instead of length-prefixed ones
+  std::size_t fixed_key_size = 0;
+  std::size_t fixed_value_size = 0;
+
+  //! if set, the progression of each partition is stored in this subspace (in the same transaction as the loaded
+  //! key/values) and a load of the same input resume from there (the number of partitions has to be the same)
+  std::optional<subspace> checkpoint{};
+};
+
+/**
+ * @brief Statistics of a bulk load
+ */
+struct load_stats {
+  std::size_t records = 0;
+  //! size of the loaded keys and values
+  std::size_t bytes = 0;
+  std::size_t transactions = 0;
+  std::size_t retries = 0;
+  //! number of partitions already completely loaded by a previous (checkpointed) load
+  std::size_t resumed_partitions = 0;
+};
+
+/**
+ * @brief Load a file of key/values in foundationdb.
+ *
+ * The file is memory-mapped (keys and values are put in the transactions directly from the mapping, without copy),
+ * split in partitions of contiguous records (each partition being a key range if the input is sorted) and loaded by
+ * a pool of threads, each committing transactions of max_batch_bytes.
+ * Transactions are retried on retry-able errors. As the key/values of the same transaction are put again on retry,
+ * loading an input twice is idempotent.
+ *
+ * Input format (default), length-prefixed records:
+ * [key length: uint32 little endian][key][value length: uint32 little endian][value]...
+ *
+ * If fixed_key_size is set in the options, records are [key][value] of fixed size (fixed_key_size and fixed_value_size).
+ */
+class bulk_loader {
+  struct internal;
+
+public:
+  ~bulk_loader();
+
+  /**
+   * @param db database in which the file is loaded, must outlive the loader
+   * @param input_path path of the file to load
+   * @param opt options of the load
+   * @throw fdb_exception if the file cannot be mapped or is malformed, or if fixed_value_size is set without
+   * fixed_key_size
+   */
+  bulk_loader(free_fdb &db, const std::string &input_path, load_options opt = {});
+
+  /**
+   * @brief Load the input, resuming from the checkpoint if set in the options
+   *
+   * @return statistics of the load
+   * @throw the first exception thrown by a loading thread (non retry-able fdb_exception), the other threads are stopped
+   * as soon as possible. Already committed transactions are kept (and checkpointed if enabled).
+   */
+  load_stats load();
+
+  /**
+   * @brief Remove the checkpoint of the input (if set in the options), a next load start from the beginning
+   */
+  void clear_checkpoint();
+
+  /**
+   * @return number of partitions the input is split into
+   */
+  [[nodiscard]] std::size_t partitions() const;
+
+  /**
+   * @brief Append a length-prefixed record to the provided buffer (format of the input of the bulk loader)
+   */
+  static void encode_record(std::string &out, std::string_view key, std::string_view value);
+
+private:
+  std::unique_ptr<internal> _impl;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_BULK_LOADER_HH
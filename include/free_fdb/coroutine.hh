@@ -0,0 +1,307 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_COROUTINE_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_COROUTINE_HH
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <variant>
+
+#include "ffdb.hh"
+
+/**
+ * C++20 coroutine layer on top of the asynchronous operations of free_fdb (available with the free_fdb_coroutine
+ * target, enabled by the FFDB_COROUTINE cmake option).
+ *
+ * Any fdb_async can be co_await-ed, the coroutine is suspended until the future is ready:
+ *
+ * ffdb::task<std::string> handler(ffdb::fdb_transaction &trans) {
+ *   auto user = co_await trans.get_async("user");
+ *   auto settings = co_await trans.get_async(user->value + "/settings");
+ *   co_await trans.commit_async();
+ *   co_return settings->value;
+ * }
+ */
+namespace ffdb {
+
+/**
+ * @brief Awaiter on an asynchronous result, the coroutine is resumed on the foundationdb network thread
+ *
+ * @warning until the next co_await, the coroutine is running on the network thread and must not block (calling a
+ * blocking method such as fdb_transaction::get would deadlock).
+ */
+template<typename T>
+class fdb_awaiter {
+
+public:
+  explicit fdb_awaiter(fdb_async<T> async) : _async(std::move(async)) {}
+
+  [[nodiscard]] bool await_ready() const {
+	return _async.is_ready();
+  }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+	_async.then([handle](const fdb_async<T> &) { handle.resume(); });
+  }
+
+  T await_resume() {
+	return _async.get();
+  }
+
+protected:
+  fdb_async<T> _async;
+};
+
+/**
+ * @brief Awaiter on an asynchronous result, the coroutine is resumed by the provided executor instead of the network
+ * thread.
+ *
+ * @tparam Executor any type with a post method taking a callable with the signature void()
+ */
+template<typename T, typename Executor>
+class fdb_executor_awaiter : public fdb_awaiter<T> {
+
+public:
+  fdb_executor_awaiter(Executor &executor, fdb_async<T> async) : fdb_awaiter<T>(std::move(async)), _executor(executor) {}
+
+  /**
+   * Always suspend, even if the result is already ready, so that the coroutine is resumed on the executor
+   */
+  [[nodiscard]] bool await_ready() const {
+	return false;
+  }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+	this->_async.then([handle, &executor = _executor](const fdb_async<T> &) {
+	  executor.post([handle]() { handle.resume(); });
+	});
+  }
+
+private:
+  Executor &_executor;
+};
+
+template<typename T>
+fdb_awaiter<T> operator co_await(fdb_async<T> async) {
+  return fdb_awaiter<T>(std::move(async));
+}
+
+/**
+ * @brief co_await the provided asynchronous result and resume the coroutine on the given executor
+ *
+ * @param executor executor on which the coroutine is resumed, it has to outlive the awaiting
+ * @param async asynchronous result to await
+ */
+template<typename Executor, typename T>
+fdb_executor_awaiter<T, Executor> resume_on(Executor &executor, fdb_async<T> async) {
+  return fdb_executor_awaiter<T, Executor>(executor, std::move(async));
+}
+
+template<typename T = void>
+class task;
+
+namespace coroutine_internal {
+
+template<typename T>
+struct promise_base {
+
+  struct final_awaiter {
+	[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+	template<typename Promise>
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+	  if (auto continuation = handle.promise().continuation) {
+		return continuation;
+	  }
+	  return std::noop_coroutine();
+	}
+
+	void await_resume() noexcept {}
+  };
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  final_awaiter final_suspend() noexcept { return {}; }
+
+  void unhandled_exception() noexcept {
+	result = std::current_exception();
+  }
+
+  std::coroutine_handle<> continuation = nullptr;
+  std::variant<std::monostate, T, std::exception_ptr> result;
+};
+
+template<typename T>
+struct promise : promise_base<T> {
+
+  task<T> get_return_object() noexcept;
+
+  template<typename U>
+  void return_value(U &&value) {
+	this->result.template emplace<1>(std::forward<U>(value));
+  }
+
+  T take_result() {
+	if (this->result.index() == 2) {
+	  std::rethrow_exception(std::get<2>(this->result));
+	}
+	return std::move(std::get<1>(this->result));
+  }
+};
+
+template<>
+struct promise<void> : promise_base<std::monostate> {
+
+  task<void> get_return_object() noexcept;
+
+  void return_void() noexcept {}
+
+  void take_result() {
+	if (this->result.index() == 2) {
+	  std::rethrow_exception(std::get<2>(this->result));
+	}
+  }
+};
+
+struct detached_task {
+  struct promise_type {
+	detached_task get_return_object() noexcept { return {}; }
+	std::suspend_never initial_suspend() noexcept { return {}; }
+	std::suspend_never final_suspend() noexcept { return {}; }
+	void return_void() noexcept {}
+	void unhandled_exception() noexcept {}
+  };
+};
+
+}// namespace coroutine_internal
+
+/**
+ * @brief Lazy coroutine type, the coroutine start when the task is co_await-ed (or given to sync_wait / spawn)
+ * @tparam T type returned by the coroutine (with co_return)
+ */
+template<typename T>
+class task {
+
+public:
+  using promise_type = coroutine_internal::promise<T>;
+
+  ~task() {
+	if (_handle) {
+	  _handle.destroy();
+	}
+  }
+  task(const task &) = delete;
+  task(task &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+  explicit task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+  [[nodiscard]] bool await_ready() const noexcept {
+	return !_handle || _handle.done();
+  }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+	_handle.promise().continuation = awaiting;
+	return _handle;
+  }
+
+  T await_resume() {
+	return _handle.promise().take_result();
+  }
+
+private:
+  std::coroutine_handle<promise_type> _handle;
+};
+
+namespace coroutine_internal {
+
+template<typename T>
+task<T> promise<T>::get_return_object() noexcept {
+  return task<T>(std::coroutine_handle<promise<T>>::from_promise(*this));
+}
+
+inline task<void> promise<void>::get_return_object() noexcept {
+  return task<void>(std::coroutine_handle<promise<void>>::from_promise(*this));
+}
+
+}// namespace coroutine_internal
+
+/**
+ * @brief Start the provided task and block the calling thread until it is completed
+ *
+ * @warning must not be called from the network thread (from a coroutine resumed by a fdb_awaiter for instance)
+ * @return the value returned by the task, exception thrown by the task are re-thrown
+ */
+template<typename T>
+T sync_wait(task<T> t) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>> result;
+  std::exception_ptr error;
+
+  [](task<T> &t, auto &result, std::exception_ptr &error, std::mutex &mutex, std::condition_variable &cv, bool &done)
+	  -> coroutine_internal::detached_task {
+	try {
+	  if constexpr (std::is_void_v<T>) {
+		co_await t;
+		result.emplace();
+	  } else {
+		result.emplace(co_await t);
+	  }
+	} catch (...) {
+	  error = std::current_exception();
+	}
+	std::scoped_lock lock(mutex);
+	done = true;
+	cv.notify_one();
+  }(t, result, error, mutex, cv, done);
+
+  std::unique_lock lock(mutex);
+  cv.wait(lock, [&done] { return done; });
+  if (error) {
+	std::rethrow_exception(error);
+  }
+  if constexpr (!std::is_void_v<T>) {
+	return std::move(*result);
+  }
+}
+
+/**
+ * @brief Start the provided task without waiting for its completion, the task is destroyed when completed.
+ * Exceptions thrown by the task are discarded, they have to be handled inside the task.
+ */
+inline void spawn(task<void> t) {
+  [](task<void> t) -> coroutine_internal::detached_task {
+	try {
+	  co_await t;
+	} catch (...) {
+	}
+  }(std::move(t));
+}
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_COROUTINE_HH
@@ -0,0 +1,142 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_COUNTER_AGGREGATOR_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_COUNTER_AGGREGATOR_HH
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ffdb.hh"
+
+namespace ffdb {
+
+class counter_aggregator;
+
+/**
+ * @brief Options of a counter_aggregator
+ */
+struct aggregator_options {
+  //! time between two flushes of the buffered increments
+  std::chrono::milliseconds flush_interval{100};
+  //! timeout of the flush transaction (retries included), if it is exceeded the flush fails: the increments stay
+  //! buffered and are flushed with the next flush
+  std::chrono::milliseconds flush_timeout{1000};
+  //! maximum number of counters that can be registered on the aggregator
+  std::size_t max_counters = 256;
+  //! called (on the flush thread, or on the destroying thread for the last flush) with the error of a failed
+  //! background flush, the increments of a failed last flush are lost
+  std::function<void(const fdb_exception &error)> on_flush_error{};
+};
+
+/**
+ * @brief Handle on a counter registered on a counter_aggregator, cheap to copy. The handle must not outlive its
+ * aggregator.
+ */
+class aggregated_counter {
+  friend class counter_aggregator;
+
+public:
+  /**
+   * Buffer an increment of the counter, applied in foundationdb at the next flush of the aggregator.
+   * @param increment amount to increment on the counter
+   */
+  void add(std::int64_t increment = 1) const;
+
+  /**
+   * Buffer a decrement of the counter, applied in foundationdb at the next flush of the aggregator.
+   * @param decrement amount to decrement from the counter
+   */
+  void sub(std::int64_t decrement = 1) const;
+
+  /**
+   * @return retrieve the db key of the counter
+   */
+  [[nodiscard]] const std::string &key() const;
+
+private:
+  aggregated_counter(counter_aggregator &aggregator, std::size_t index) : _aggregator(&aggregator), _index(index) {}
+
+  counter_aggregator *_aggregator;
+  std::size_t _index;
+};
+
+/**
+ * @brief Process-local aggregation of counter increments.
+ *
+ * Instead of applying an atomic operation for each increment, increments are accumulated in memory (in per-thread
+ * slots, each on its own cache line, no lock is taken when incrementing) and periodically flushed by a background
+ * thread: each flush apply a single FDB_MUTATION_TYPE_ADD per counter, all the counters being flushed in one
+ * transaction.
+ *
+ * The counters are stored as std::int64_t (little endian), and can thus be read with an fdb_counter on the same key.
+ *
+ * @warning buffered increments are lost if the process stops without destroying the aggregator. An increment can
+ * be applied twice if the flush commit result is unknown (commit_unknown_result error), as for any atomic operation
+ * retried by foundationdb.
+ */
+class counter_aggregator {
+  struct internal;
+  friend class aggregated_counter;
+
+public:
+  /**
+   * Stop the flush thread and flush the remaining buffered increments (an error is reported to
+   * aggregator_options::on_flush_error).
+   */
+  ~counter_aggregator();
+
+  /**
+   * @param db database on which the increments are flushed, must outlive the aggregator
+   * @param opt flush configuration of the aggregator
+   */
+  explicit counter_aggregator(free_fdb &db, aggregator_options opt = {});
+
+  /**
+   * @brief Register a counter on the aggregator, registering the same key multiple time return the same counter
+   *
+   * @param key of the counter in foundationdb
+   * @return handle on the counter to increment
+   * @throw fdb_exception if the maximum number of counter (see aggregator_options::max_counters) is reached
+   */
+  aggregated_counter make_counter(std::string_view key);
+
+  /**
+   * @brief Flush the buffered increments now, in a single transaction
+   * @throw fdb_exception if the flush failed (the increments stay buffered and are flushed with the next flush)
+   */
+  void flush();
+
+private:
+  void add(std::size_t index, std::int64_t increment);
+
+  std::unique_ptr<internal> _impl;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_COUNTER_AGGREGATOR_HH
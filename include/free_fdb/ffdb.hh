@@ -26,37 +26,55 @@
 
 #include <fmt/format.h>
 
+#include <chrono>
 #include <exception>
+#include <initializer_list>
+#include <iterator>
 #include <optional>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 #define FDB_API_VERSION 610
 #include <foundationdb/fdb_c.h>
 
+#include "async.hh"
 #include "iterator.hh"
+#include "view.hh"
 
 namespace ffdb {
 
 class fdb_exception : public std::exception {
 public:
-  explicit fdb_exception(std::string message) : std::exception(), _message(std::move(message)) {
+  explicit fdb_exception(std::string message, fdb_error_t code = 0) : std::exception(), _message(std::move(message)), _code(code) {
   }
 
   [[nodiscard]] const char *what() const noexcept override {
 	return _message.c_str();
   }
 
+  /**
+   * @return foundationdb error code at the origin of the exception, 0 if the error doesn't come from foundationdb
+   * @see https://apple.github.io/foundationdb/api-error-codes.html
+   */
+  [[nodiscard]] fdb_error_t code() const noexcept {
+	return _code;
+  }
+
 private:
   std::string _message;
+  fdb_error_t _code;
 };
 
 class transaction_exception : public fdb_exception {
 public:
-  explicit transaction_exception(std::string message) : fdb_exception(std::move(message)) {
+  explicit transaction_exception(std::string message, fdb_error_t code = 0) : fdb_exception(std::move(message), code) {
   }
 };
 
 class free_fdb;
+class subspace;
+class watch_handle;
 
 /**
  * @brief Possible Options for range selection on a transaction (used by fdb_transaction::get_range method)
@@ -74,6 +92,61 @@ struct range_options {
 
   bool lower_bound_inclusive = true;
   bool upper_bound_inclusive = false;
+
+  //! if true, the range is read with a snapshot read (no read conflict) even if snapshot is not enabled on the transaction
+  bool snapshot = false;
+};
+
+/**
+ * @brief Options for range streaming (used by fdb_transaction::get_range_stream)
+ *
+ * In addition to the range_options, the streaming mode used to retrieve each batch and the direction of the
+ * iteration can be selected. The limit option applies to the whole stream.
+ */
+struct stream_options : range_options {
+  //! streaming mode used to retrieve the batches (with ITERATOR, the batch size grows as the stream progress)
+  FDBStreamingMode mode = FDBStreamingMode::FDB_STREAMING_MODE_ITERATOR;
+  //! if true, the range is streamed from the end to the beginning
+  bool reverse = false;
+};
+
+/**
+ * @brief Priority of a transaction
+ * @see https://apple.github.io/foundationdb/api-c.html#c.FDBTransactionOption
+ */
+enum class transaction_priority {
+  //! default priority
+  normal,
+  //! lower priority, for background jobs, throttled first when the cluster is saturated
+  batch,
+  //! highest priority, the read version is retrieved immediately (reserved for administrative work, can overload the
+  //! cluster)
+  system_immediate
+};
+
+/**
+ * @brief Options of a transaction (see fdb_transaction::set_options), unset options keep the foundationdb defaults
+ *
+ * @see https://apple.github.io/foundationdb/api-c.html#c.FDBTransactionOption
+ */
+struct transaction_options {
+  //! the transaction (retries included) is cancelled with a transaction_timed_out error after this duration
+  std::optional<std::chrono::milliseconds> timeout{};
+  //! maximum number of retries with on_error (-1 for no limit)
+  std::optional<int> retry_limit{};
+  //! maximum backoff delay between retries with on_error
+  std::optional<std::chrono::milliseconds> max_retry_delay{};
+  //! maximum size in bytes of the transaction (defaults to 10MB)
+  std::optional<std::int64_t> size_limit{};
+  //! reads don't see the writes of the transaction (faster for blind writes and for reads only transactions)
+  bool read_your_writes_disable = false;
+  //! disable the read ahead caching of range reads
+  bool read_ahead_disable = false;
+  //! the read version can be slightly stale in case of fault (faster reads)
+  bool causal_read_risky = false;
+  transaction_priority priority = transaction_priority::normal;
+  //! the transaction can run on a locked database
+  bool lock_aware = false;
 };
 
 /**
@@ -89,12 +162,44 @@ public:
   fdb_transaction(const fdb_transaction &) = delete;
   explicit fdb_transaction(FDBDatabase *db);
 
+  /**
+   * @param db database on which the transaction is made
+   * @param defaults options applied at creation, and re-applied each time the transaction is reset
+   */
+  fdb_transaction(FDBDatabase *db, transaction_options defaults);
+
+  /**
+   * @brief Apply the provided options on the transaction (options are cleared by reset, the defaults given at
+   * construction excepted)
+   */
+  void set_options(const transaction_options &options);
+
+  void set_timeout(std::chrono::milliseconds timeout);
+  void set_retry_limit(int retry_limit);
+  void set_max_retry_delay(std::chrono::milliseconds delay);
+  void set_size_limit(std::int64_t bytes);
+  void disable_read_your_writes();
+  void disable_read_ahead();
+  void set_causal_read_risky();
+  void set_priority(transaction_priority priority);
+  void set_lock_aware();
+
+  /**
+   * @brief Allow the transaction to read the system keys (keys starting with \\xff)
+   */
+  void set_read_system_keys();
+
   /**
    * @brief Enable snapshot
    * @see https://apple.github.io/foundationdb/api-c.html#snapshot-reads
    */
   void enable_snapshot();
 
+  /**
+   * @brief Disable snapshot, reads are done with the default (serializable) isolation
+   */
+  void disable_snapshot();
+
   /**
    * @brief Commit the current transaction
    *
@@ -103,7 +208,37 @@ public:
   void commit();
 
   /**
-   * @brief Reset the current transaction to its original state
+   * @brief Commit the current transaction without blocking the calling thread
+   * @return asynchronous result, get() throws if the commit failed
+   * @throw fdb_exception if the transaction is null
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_commit
+   */
+  [[nodiscard]] fdb_async<void> commit_async();
+
+  /**
+   * @brief Handle an error that occurred on the transaction. If the error is retry-able, the transaction is reset
+   * and the call block for the time of the backoff (exponential, managed by foundationdb), the transaction can then
+   * be retried.
+   *
+   * @param error foundationdb error code that occurred on the transaction (see fdb_exception::code)
+   * @throw fdb_exception (or transaction_exception) if the error is not retry-able
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_on_error
+   */
+  void on_error(fdb_error_t error);
+
+  /**
+   * @brief Asynchronous version of fdb_transaction::on_error, the returned future is ready when the transaction can
+   * be retried (after the backoff), and is in error if the error is not retry-able. The defaults given at construction
+   * that foundationdb does not keep on retry are applied again when the result is retrieved with get().
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_on_error
+   */
+  [[nodiscard]] fdb_async<void> on_error_async(fdb_error_t error);
+
+  /**
+   * @brief Reset the current transaction to its original state (the snapshot mode is kept)
    *
    * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_reset
    */
@@ -115,13 +250,19 @@ public:
    * @param key to insert
    * @param value to insert
    */
-  void put(const std::string &key, const std::string &value);
+  void put(std::string_view key, std::string_view value);
+  void put(const uint8_t *key, std::size_t key_length, const uint8_t *value, std::size_t value_length) {
+	put(bytes_view(key, key_length), bytes_view(value, value_length));
+  }
 
   /**
    * @brief Remove a selected key from the DB
    * @param key to delete in foundationdb
    */
-  void del(const std::string &key);
+  void del(std::string_view key);
+  void del(const uint8_t *key, std::size_t key_length) {
+	del(bytes_view(key, key_length));
+  }
 
   /**
    * @brief Delete the range of key value between the provided begin and end inclusive
@@ -129,7 +270,97 @@ public:
    * @param key_begin key to start the deletion from (included)
    * @param key_end deletion up to that key (included)
    */
-  void del_range(const std::string &key_begin, const std::string &key_end);
+  void del_range(std::string_view key_begin, std::string_view key_end);
+  void del_range(const uint8_t *key_begin, std::size_t key_begin_length, const uint8_t *key_end, std::size_t key_end_length) {
+	del_range(bytes_view(key_begin, key_begin_length), bytes_view(key_end, key_end_length));
+  }
+
+  /**
+   * @brief Delete all the keys of the provided subspace
+   */
+  void del_range(const subspace &space);
+
+  /**
+   * @brief Apply an atomic operation on the provided key
+   *
+   * @param key on which the operation is applied
+   * @param param parameter of the operation (its encoding depends on the operation)
+   * @param operation type of atomic operation to apply
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_atomic_op
+   */
+  void atomic_op(std::string_view key, std::string_view param, FDBMutationType operation);
+
+  /**
+   * @brief Add a conflict range to the transaction without reading or writing it. A read conflict range makes the
+   * transaction conflict with concurrent writes in the range (as if it was read), a write conflict range makes the
+   * concurrent transactions that read the range conflict (as if it was written).
+   *
+   * @param begin key from where the conflict range start (inclusive)
+   * @param end key to end the conflict range (exclusive)
+   * @param type FDB_CONFLICT_RANGE_TYPE_READ or FDB_CONFLICT_RANGE_TYPE_WRITE
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_add_conflict_range
+   */
+  void add_conflict_range(std::string_view begin, std::string_view end, FDBConflictRangeType type);
+
+  /**
+   * @brief Same as fdb_transaction::add_conflict_range on the range containing only the provided key
+   */
+  void add_conflict_key(std::string_view key, FDBConflictRangeType type);
+
+  /**
+   * @brief Retrieve the versionstamp used by the transaction (10 bytes: commit version followed by the order of the
+   * transaction in its commit batch), the same versionstamp foundationdb set in versionstamped keys and values
+   * (FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_KEY / _VALUE) of the transaction.
+   *
+   * Has to be called before the commit, the result is ready once the commit succeeded (and is in error otherwise).
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_get_versionstamp
+   */
+  [[nodiscard]] fdb_async<std::string> get_versionstamp();
+
+  /**
+   * @brief Watch the provided key, the returned result is ready when the value of the key changes from the value seen
+   * by the transaction. The watch is activated by the commit of the transaction (a read-only transaction can be
+   * committed without round trip), and is set in error if the commit fails or if the transaction is reset before.
+   * Once activated, the watch outlives the transaction, cancel the result to release it.
+   *
+   * @warning a watch can be triggered without change of the value (ABA), and the number of active watches is limited
+   * by the database (see free_fdb::set_max_watches), beyond it the watch fails with a too_many_watches error (1032)
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_watch
+   */
+  [[nodiscard]] fdb_async<void> watch(std::string_view key);
+
+  /**
+   * @brief Retrieve the read version of the transaction, fetched from the cluster by the first read of the transaction
+   * (or by this call) unless it has been set with fdb_transaction::set_read_version.
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_get_read_version
+   */
+  [[nodiscard]] fdb_async<std::int64_t> get_read_version();
+
+  /**
+   * @brief Set the version at which the transaction reads, the transaction doesn't fetch a read version from the
+   * cluster (saving a round trip). Has to be called before any read. The version is cleared when the transaction is
+   * reset.
+   *
+   * @warning the transaction doesn't see the commits made after the provided version, reads fail with a
+   * transaction_too_old error (1007) if the version is older than ~5 seconds
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_set_read_version
+   */
+  void set_read_version(std::int64_t version);
+
+  /**
+   * @brief User version to complete the versionstamps of the transaction with (see tuple::versionstamp), the value is
+   * incremented at each call in order to order the versionstamped keys of a same transaction. Restart from 0 when
+   * the transaction is reset or retried (on_error).
+   */
+  [[nodiscard]] std::uint16_t next_user_version() {
+	return _user_version++;
+  }
 
   /**
    * @warning this method is for internal purpose only and should not be used in order to improvise C API calls
@@ -143,7 +374,67 @@ public:
    * @param key to retrieve from the database
    * @return a key value structure if present, std::nullopt otherwise
    */
-  std::optional<fdb_result> get(const std::string &key);
+  std::optional<fdb_result> get(std::string_view key);
+  std::optional<fdb_result> get(const uint8_t *key, std::size_t key_length) {
+	return get(bytes_view(key, key_length));
+  }
+
+  /**
+   * @brief Asynchronous version of fdb_transaction::get, the read is issued without blocking the calling thread.
+   * Multiple reads can be issued before waiting any of them in order to have them in flight at the same time.
+   *
+   * @param key to retrieve from the database
+   * @return asynchronous result containing a key value structure if present, std::nullopt otherwise
+   * @throw fdb_exception if the transaction is null
+   */
+  [[nodiscard]] fdb_async<std::optional<fdb_result>> get_async(std::string_view key);
+
+  /**
+   * @brief Zero-copy version of fdb_transaction::get, the value is not copied and is accessed as std::string_view
+   * directly from the foundationdb future (kept alive by the returned handle).
+   *
+   * @param key to retrieve from the database
+   * @return handle on the value, evaluate to false if the key is not present
+   */
+  value_view get_view(std::string_view key);
+  value_view get_view(const uint8_t *key, std::size_t key_length) {
+	return get_view(bytes_view(key, key_length));
+  }
+
+  /**
+   * @brief Asynchronous version of fdb_transaction::get_view
+   * @throw fdb_exception if the transaction is null
+   */
+  [[nodiscard]] fdb_async<value_view> get_view_async(std::string_view key);
+
+  /**
+   * @brief Retrieve multiple keys at once. All the reads are issued before waiting for any of them, the reads are
+   * thus in flight at the same time instead of costing one round trip each.
+   *
+   * @param keys container of keys to retrieve from the database (any iterable container of type convertible to
+   * std::string_view)
+   * @return zero-copy value handles, in the same order than the provided keys (a handle evaluate to false if its key
+   * is not present)
+   */
+  template<typename Keys>
+  std::vector<value_view> multi_get(const Keys &keys) {
+	std::vector<fdb_async<value_view>> pending;
+	pending.reserve(std::size(keys));
+	for (const auto &key : keys) {
+	  pending.emplace_back(get_view_async(key));
+	}
+
+	std::vector<value_view> result;
+	result.reserve(pending.size());
+	for (const auto &read : pending) {
+	  result.emplace_back(read.get());
+	}
+	return result;
+  }
+
+  std::vector<value_view> multi_get(std::initializer_list<std::string_view> keys) {
+	return multi_get<std::initializer_list<std::string_view>>(keys);
+  }
 
   /**
    * @brief Efficiently retrieve a full (depending on the potential limitation in the given option) range following
@@ -160,13 +451,121 @@ public:
    *
    * @see https://apple.github.io/foundationdb/api-c.html#c.FDBStreamingMode
    */
-  range_result get_range(const std::string &from, const std::string &to, range_options opt = {});
+  range_result get_range(std::string_view from, std::string_view to, range_options opt = {});
+  range_result get_range(const uint8_t *from, std::size_t from_length, const uint8_t *to, std::size_t to_length, range_options opt = {}) {
+	return get_range(bytes_view(from, from_length), bytes_view(to, to_length), opt);
+  }
+
+  /**
+   * @brief Retrieve the range of all the keys of the provided subspace (bounds inclusion from the options are ignored)
+   */
+  range_result get_range(const subspace &space, range_options opt = {});
+
+  /**
+   * @brief Asynchronous version of fdb_transaction::get_range
+   *
+   * @param from key from where to start the range (inclusive/exclusive depending on options)
+   * @param to key to end the range selection (inclusive/exclusive depending on options)
+   * @param opt additional options for selection (limit / inclusion / exclusion etc..)
+   *
+   * @return asynchronous result containing the range found from the foundation db respecting the provided options.
+   */
+  [[nodiscard]] fdb_async<range_result> get_range_async(std::string_view from, std::string_view to, range_options opt = {});
+
+  /**
+   * @brief Zero-copy version of fdb_transaction::get_range, the key/value pairs are not copied and are accessed as
+   * std::string_view directly from the foundationdb future (kept alive by the returned view).
+   *
+   * @param from key from where to start the range (inclusive/exclusive depending on options)
+   * @param to key to end the range selection (inclusive/exclusive depending on options)
+   * @param opt additional options for selection (limit / inclusion / exclusion etc..)
+   *
+   * @return view on the range found from the foundation db respecting the provided options.
+   */
+  range_view get_range_view(std::string_view from, std::string_view to, range_options opt = {});
+  range_view get_range_view(const uint8_t *from, std::size_t from_length, const uint8_t *to, std::size_t to_length, range_options opt = {}) {
+	return get_range_view(bytes_view(from, from_length), bytes_view(to, to_length), opt);
+  }
+
+  /**
+   * @brief Zero-copy version of fdb_transaction::get_range on a subspace
+   */
+  range_view get_range_view(const subspace &space, range_options opt = {});
+
+  /**
+   * @brief Asynchronous version of fdb_transaction::get_range_view
+   */
+  [[nodiscard]] fdb_async<range_view> get_range_view_async(std::string_view from, std::string_view to, range_options opt = {});
+
+  /**
+   * @brief Stream a range by batches. Each batch is retrieved with the streaming mode selected in the options (with
+   * an increasing iteration number, used by foundationdb to grow the batch size with the ITERATOR mode), the stream
+   * automatically continue after the last key of the previous batch until the range is exhausted (or the limit is
+   * reached).
+   *
+   * The next batch is requested before the handler is called on the current one, the network round trip overlaps the
+   * handling of the batch.
+   *
+   * @param from key from where to start the range (inclusive/exclusive depending on options)
+   * @param to key to end the range selection (inclusive/exclusive depending on options)
+   * @param handler called with each (non-empty) batch of the range, in order
+   * @param opt additional options for selection (streaming mode / limit / inclusion / exclusion / direction etc..)
+   *
+   * @return total number of key/value retrieved
+   *
+   * @see https://apple.github.io/foundationdb/api-c.html#c.FDBStreamingMode
+   */
+  std::size_t get_range_stream(
+	  std::string_view from, std::string_view to, const std::function<void(const range_view &)> &handler, stream_options opt = {});
 
 private:
   FDBTransaction *_trans = nullptr;
   bool _snapshot_enabled = false;
+  std::uint16_t _user_version = 0;
+  transaction_options _defaults{};
 };
 
+/**
+ * @brief Statistics of a transaction executed with free_fdb::run
+ */
+struct run_stats {
+  //! number of time the transaction has been retried
+  std::uint32_t retries = 0;
+  //! total time spent in the run call, backoff between retries included
+  std::chrono::nanoseconds elapsed{};
+  //! last foundationdb error code that made the transaction retry (0 if none)
+  fdb_error_t last_error = 0;
+};
+
+/**
+ * @brief Options of the read version cache of a free_fdb instance (see free_fdb::enable_read_version_cache)
+ */
+struct read_version_options {
+  //! maximum age of the shared read version, an older one is fetched again before being given to a transaction (has
+  //! to be lower than 5 seconds, foundationdb lifetime of a read version)
+  std::chrono::milliseconds max_staleness{100};
+  //! interval at which the shared read version is refreshed in background
+  std::chrono::milliseconds refresh_interval{20};
+};
+
+/**
+ * @brief Deleter of a pooled_transaction, give the transaction back to the pool of its free_fdb instance (or destroy it
+ * if the pool is full)
+ */
+struct transaction_recycler {
+  free_fdb *db = nullptr;
+  //! generation of the defaults of the free_fdb instance when the transaction was acquired
+  std::uint64_t generation = 0;
+
+  void operator()(fdb_transaction *transaction) const;
+};
+
+/**
+ * @brief Transaction taken from the transaction pool of a free_fdb instance, given back to the pool (and reset) when
+ * the handle goes out of scope.
+ */
+using pooled_transaction = std::unique_ptr<fdb_transaction, transaction_recycler>;
+
 /**
  * @brief RAII Object representing an instance of the foundationdb,
  * At construction time a thread is launched in order to handle the fdb network.
@@ -180,16 +579,113 @@ private:
  */
 class free_fdb {
   struct internal;
+  friend struct transaction_recycler;
 
 public:
   ~free_fdb();
-  explicit free_fdb(const std::string &cluster_file_path);
+
+  /**
+   * @param cluster_file_path path of the cluster file of the database
+   * @param transaction_pool_size maximum number of transactions kept for reuse by acquire_transaction (0 disable the
+   * pooling)
+   */
+  explicit free_fdb(const std::string &cluster_file_path, std::size_t transaction_pool_size = 64);
 
   /**
    * @return a pointer on a newly created transaction raii object
    */
   [[nodiscard]] std::unique_ptr<fdb_transaction> make_transaction();
 
+  /**
+   * @brief Take a transaction from the transaction pool (a new transaction is created if the pool is empty). The
+   * transaction is reset and given back to the pool when the returned handle goes out of scope, short-lived
+   * transactions thus cost no allocation nor transaction creation once the pool is warm.
+   *
+   * The pool is lock-free and shared between the threads.
+   *
+   * @warning the handle must not outlive the free_fdb instance
+   * @return handle on a transaction in its initial state
+   */
+  [[nodiscard]] pooled_transaction acquire_transaction();
+
+  /**
+   * @brief Set the options applied to every transaction created from now on by this instance (make_transaction,
+   * acquire_transaction, run...), they are kept when the transactions are reset.
+   *
+   * The transactions of the pool are destroyed, as well as the pooled transactions in use when they are given back, so
+   * that acquire_transaction only gives transactions with the new defaults.
+   */
+  void set_transaction_options(transaction_options options);
+
+  /**
+   * @brief Number of shard locations cached by the client (defaults to 100000)
+   * @see https://apple.github.io/foundationdb/api-c.html#c.FDBDatabaseOption
+   */
+  void set_location_cache_size(int size);
+
+  /**
+   * @brief Maximum number of watches outstanding on the database (defaults to 10000), setting a watch beyond this limit
+   * fails with a too_many_watches error
+   * @see https://apple.github.io/foundationdb/api-c.html#c.FDBDatabaseOption
+   */
+  void set_max_watches(int max_watches);
+
+  /**
+   * @brief Enable the read version cache: a read version is fetched once and shared by all the transactions made with
+   * make_read_transaction, it is refreshed in background every refresh_interval. Short read-only transactions then
+   * don't pay the GetReadVersion round trip to the cluster.
+   *
+   * The shared version can be up to max_staleness old, the read transactions may not see the commits made during
+   * that window (including the commits of the calling thread).
+   *
+   * @warning not thread-safe with make_read_transaction / read_version, it is meant to be called at startup
+   * @throw fdb_exception if max_staleness is not lower than 5 seconds, or if the first read version can't be fetched
+   */
+  void enable_read_version_cache(read_version_options options = {});
+
+  /**
+   * @brief Stop the background refresh of the read version, make_read_transaction then fetch a read version per
+   * transaction again.
+   *
+   * @warning not thread-safe with make_read_transaction / read_version
+   */
+  void disable_read_version_cache();
+
+  /**
+   * @brief Read version shared by the read transactions if the read version cache is enabled, a newly fetched read
+   * version otherwise.
+   *
+   * A group of threads can share a consistent snapshot of the database by each making a transaction with
+   * make_transaction_at on the same version.
+   */
+  [[nodiscard]] std::int64_t read_version();
+
+  /**
+   * @brief Take a transaction from the transaction pool (see acquire_transaction) which reads at the shared read
+   * version if the read version cache is enabled (see enable_read_version_cache).
+   *
+   * The transaction is meant to be read-only: as it reads in the past, a commit of it is more likely to conflict.
+   */
+  [[nodiscard]] pooled_transaction make_read_transaction();
+
+  /**
+   * @brief Take a transaction from the transaction pool (see acquire_transaction) which reads at the provided version
+   * (see fdb_transaction::set_read_version)
+   */
+  [[nodiscard]] pooled_transaction make_transaction_at(std::int64_t version);
+
+  /**
+   * @brief Call the callback each time the provided key is modified, until the returned handle is destroyed. The
+   * watches are managed by a watcher owned by the instance (created at the first call, with the default options), see
+   * watcher::watch.
+   *
+   * @param key to watch
+   * @param callback called with the key on the watcher thread
+   * @return handle of the watch (see free_fdb/watch.hh), must not outlive the free_fdb instance
+   * @throw fdb_exception with the too_many_watches error code if the maximum number of watches is reached
+   */
+  [[nodiscard]] watch_handle watch(std::string_view key, std::function<void(const std::string &)> callback);
+
   /**
    * @brief Make an iterator on the foundationdb, depending on the function called on the iterator to start the iteration
    * the upper_bound / lower_bound from it_options is used or not.
@@ -206,7 +702,69 @@ public:
    */
   fdb_iterator make_iterator(ffdb::it_options range = {});
 
+  /**
+   * @brief Make an iterator on the keys of the provided subspace, the lower/upper bounds of the options are replaced
+   * by the range of the subspace
+   */
+  fdb_iterator make_iterator(const subspace &space, ffdb::it_options opt = {});
+
+  /**
+   * @brief Execute the provided handler in a transaction and commit it. In case of retry-able error (conflict,
+   * transaction too old...) thrown by the handler or the commit, the transaction is retried using
+   * fdb_transaction::on_error, which reset the same transaction and apply foundationdb exponential backoff.
+   *
+   * As the handler may be called several times, it should not have side effects outside of the transaction (or those
+   * have to be idempotent).
+   *
+   * @param handler callable with the signature R(fdb_transaction &)
+   * @param stats if provided, filled with the number of retries and time spent in the call
+   * @return the value returned by the handler on the successful attempt
+   * @throw fdb_exception if a non retry-able error occurred, exceptions not coming from foundationdb thrown by the
+   * handler are propagated without retry.
+   */
+  template<typename Handler>
+  auto run(Handler &&handler, run_stats *stats = nullptr) -> std::invoke_result_t<Handler, fdb_transaction &> {
+	using result_type = std::invoke_result_t<Handler, fdb_transaction &>;
+
+	auto trans = acquire_transaction();
+	run_stats local_stats{};
+	run_stats &s = stats ? *stats : local_stats;
+	s = run_stats{};
+	const auto start = std::chrono::steady_clock::now();
+
+	while (true) {
+	  try {
+		if constexpr (std::is_void_v<result_type>) {
+		  handler(*trans);
+		  trans->commit();
+		  s.elapsed = std::chrono::steady_clock::now() - start;
+		  return;
+		} else {
+		  result_type result = handler(*trans);
+		  trans->commit();
+		  s.elapsed = std::chrono::steady_clock::now() - start;
+		  return result;
+		}
+	  } catch (const fdb_exception &e) {
+		if (e.code() == 0) {
+		  s.elapsed = std::chrono::steady_clock::now() - start;
+		  throw;
+		}
+		try {
+		  trans->on_error(e.code());
+		} catch (...) {
+		  s.elapsed = std::chrono::steady_clock::now() - start;
+		  throw;
+		}
+		++s.retries;
+		s.last_error = e.code();
+	  }
+	}
+  }
+
 private:
+  void recycle(fdb_transaction *transaction, std::uint64_t generation);
+
   std::unique_ptr<internal> _impl;
 };
 
@@ -217,7 +775,8 @@ private:
 class fdb_counter {
 
 public:
-  explicit fdb_counter(std::string key);
+  explicit fdb_counter(std::string_view key);
+  fdb_counter(const uint8_t *key, std::size_t key_length) : fdb_counter(bytes_view(key, key_length)) {}
 
   /**
    * Retrieve the current value of the counter
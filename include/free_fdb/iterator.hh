@@ -112,16 +112,19 @@ public:
 
   /**
    * Seek for the key provided
-   * From there, goes forward (lexicographically speaking) after each next() call
+   * From there, goes forward (lexicographically speaking) after each next() call, over all the keys prefixed by the
+   * provided key
    *
    * If none is found, the iterator is invalidated and an empty key/value pair is set for the current value held
    *
    * @param key to look for in foundationdb
+   * @throw fdb_exception if the key is empty or made only of 0xff bytes (the end of the prefix range can't be computed)
    */
   void seek(std::string key);
 
   /**
-   * Seek for the previous key before the one provided
+   * Seek for the previous key before the one provided (the last key lesser than the provided one, within the bounds
+   * set at construction time of the iterator)
    * From there, goes backward (lexicographically speaking) after each next() call
    *
    * If none is found, the iterator is invalidated and an empty key/value pair is set for the current value held
@@ -0,0 +1,219 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_METRICS_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_METRICS_HH
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace ffdb::metrics {
+
+/**
+ * @brief Operations whose latency is measured
+ *
+ * Latency of an asynchronous operation is measured from its call to the retrieval of its result (get() of the
+ * fdb_async), it is the latency of the synchronous operation when called through it (fdb_transaction::get...).
+ */
+enum class operation : std::size_t {
+  //! fdb_transaction::get_read_version (the read version implicitly fetched by the first read is part of the read)
+  get_read_version,
+  //! single key reads (get, get_view, multi_get...)
+  get,
+  //! range reads (get_range, get_range_view, each batch of get_range_stream...)
+  get_range,
+  //! page of key/value retrieved by a fdb_iterator
+  iterator_page,
+  commit,
+  //! on_error call, backoff included
+  on_error
+};
+constexpr std::size_t operation_count = 6;
+
+/**
+ * @brief Counters of the transactions and iterators
+ */
+enum class counter : std::size_t {
+  //! size of the keys and values read
+  bytes_read,
+  //! size of the keys and values written (put, atomic operations, clears)
+  bytes_written,
+  //! key/value pairs retrieved by range reads and iterators
+  rows_scanned,
+  //! not_committed errors (1020) handled by on_error
+  conflicts,
+  //! errors handled by on_error
+  retries
+};
+constexpr std::size_t counter_count = 5;
+
+[[nodiscard]] std::string_view to_string(operation op);
+[[nodiscard]] std::string_view to_string(counter c);
+
+/**
+ * @brief Latency histogram with logarithmic buckets (HDR-style): each power of 2 is split in 8 linear buckets, the
+ * relative error of a recorded value is thus lower than 12.5%, whatever its magnitude.
+ */
+class histogram {
+public:
+  static constexpr std::size_t sub_bucket_bits = 3;
+  static constexpr std::size_t sub_buckets = std::size_t{1} << sub_bucket_bits;
+  static constexpr std::size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+  /**
+   * @return index of the bucket of the provided value (in nanoseconds)
+   */
+  static std::size_t bucket_of(std::uint64_t value) {
+	if (value < sub_buckets) {
+	  return static_cast<std::size_t>(value);
+	}
+#if defined(__GNUC__) || defined(__clang__)
+	const std::size_t msb = 63 - static_cast<std::size_t>(__builtin_clzll(value));
+#else
+	std::size_t msb = 0;
+	for (std::uint64_t v = value; v > 1; v >>= 1) {
+	  ++msb;
+	}
+#endif
+	const std::size_t shift = msb - sub_bucket_bits;
+	return (shift + 1) * sub_buckets + static_cast<std::size_t>((value >> shift) & (sub_buckets - 1));
+  }
+
+  /**
+   * @return highest value (in nanoseconds) recorded in the bucket at the provided index
+   */
+  static constexpr std::uint64_t bucket_upper_bound(std::size_t index) {
+	if (index < sub_buckets) {
+	  return index;
+	}
+	const std::size_t shift = index / sub_buckets - 1;
+	const std::uint64_t mantissa = sub_buckets + index % sub_buckets;
+	return ((mantissa + 1) << shift) - 1;
+  }
+
+  void record(std::chrono::nanoseconds latency);
+
+  /**
+   * @brief Add the values recorded in the other histogram to this one
+   */
+  void merge(const histogram &other);
+
+  /**
+   * @brief Remove the values recorded in the other histogram from this one (other has to be a previous state of the
+   * histogram). The maximum becomes the one of the remaining values, at the precision of a bucket.
+   */
+  void subtract(const histogram &other);
+
+  /**
+   * @param percentile between 0 and 100
+   * @return latency under which the given percentage of the recorded values are (upper bound of their bucket)
+   */
+  [[nodiscard]] std::chrono::nanoseconds percentile(double percentile) const;
+
+  [[nodiscard]] std::chrono::nanoseconds mean() const;
+
+  [[nodiscard]] std::chrono::nanoseconds max() const {
+	return std::chrono::nanoseconds(_max);
+  }
+
+  [[nodiscard]] std::uint64_t count() const {
+	return _count;
+  }
+
+  [[nodiscard]] const std::array<std::uint64_t, bucket_count> &buckets() const {
+	return _buckets;
+  }
+
+private:
+  friend struct recorder;
+
+  std::array<std::uint64_t, bucket_count> _buckets{};
+  std::uint64_t _count = 0;
+  std::uint64_t _sum = 0;
+  std::uint64_t _max = 0;
+};
+
+/**
+ * @brief State of the metrics of the process at a given time, the values are cumulated since the start of the process
+ */
+struct snapshot {
+  std::array<histogram, operation_count> latencies{};
+  std::array<std::uint64_t, counter_count> counters{};
+
+  [[nodiscard]] const histogram &latency(operation op) const {
+	return latencies[static_cast<std::size_t>(op)];
+  }
+
+  [[nodiscard]] std::uint64_t value(counter c) const {
+	return counters[static_cast<std::size_t>(c)];
+  }
+
+  /**
+   * @return the metrics recorded between the provided (earlier) snapshot and this one
+   */
+  [[nodiscard]] snapshot since(const snapshot &earlier) const;
+};
+
+/**
+ * @brief Aggregate the metrics recorded by all the threads (without stopping them from recording)
+ */
+[[nodiscard]] snapshot take_snapshot();
+
+/**
+ * @brief Enable or disable the recording of the metrics (enabled by default). When disabled, the instrumented
+ * operations don't read the clock.
+ */
+void set_enabled(bool enabled);
+
+[[nodiscard]] bool is_enabled();
+
+/**
+ * @brief Hook called with the metrics recorded during the last interval (see exporter)
+ */
+using export_handler = std::function<void(const snapshot &delta)>;
+
+/**
+ * @brief Periodically export the metrics: a background thread takes a snapshot each interval, and call the handler
+ * with what has been recorded since the previous one. The handler is called a last time when the exporter is
+ * destroyed.
+ */
+class exporter {
+  struct internal;
+
+public:
+  ~exporter();
+  exporter(export_handler handler, std::chrono::milliseconds interval);
+
+private:
+  std::unique_ptr<internal> _impl;
+};
+
+}// namespace ffdb::metrics
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_METRICS_HH
@@ -0,0 +1,99 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_PARALLEL_SCAN_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_PARALLEL_SCAN_HH
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ffdb.hh"
+
+namespace ffdb {
+
+/**
+ * @brief Options of a parallel scan (used by parallel_scanner)
+ */
+struct scan_options {
+  //! number of threads scanning the sub-ranges concurrently
+  unsigned concurrency = std::max(1u, std::thread::hardware_concurrency());
+  //! streaming mode used by each thread to retrieve its sub-range
+  FDBStreamingMode mode = FDBStreamingMode::FDB_STREAMING_MODE_WANT_ALL;
+  //! if set, used as split points of the range instead of the shard boundaries of the database
+  std::vector<std::string> split_points{};
+};
+
+/**
+ * @brief Scan a range of key concurrently, the range is split in sub-ranges scanned by a pool of threads, each with
+ * its own (snapshot) transaction.
+ *
+ * By default, the range is split on the shard boundaries of the database (retrieved from the \\xff/keyServers/ system
+ * keys), each sub-range is then served by a different storage server team, and the scan throughput scales with the
+ * number of storage servers.
+ *
+ * A scan is not a single transaction: each sub-range is read with its own transaction, which is renewed (continuing
+ * after the last key handled) when it becomes too old or on retry-able errors. The result is thus not a consistent
+ * snapshot of the whole range.
+ */
+class parallel_scanner {
+
+public:
+  /**
+   * @param db database to scan
+   * @param begin key from where to start the scan (inclusive)
+   * @param end key to end the scan (exclusive)
+   * @param opt options of the scan
+   */
+  parallel_scanner(free_fdb &db, std::string begin, std::string end, scan_options opt = {});
+
+  /**
+   * @return the split points (excluding begin and end) the range is going to be split on
+   */
+  [[nodiscard]] std::vector<std::string> split_points() const;
+
+  /**
+   * @brief Scan the range, the sink is called with each batch of key/value retrieved.
+   *
+   * @warning the sink is called concurrently from the scanning threads, it has to be thread-safe. Batches of a same
+   * sub-range are handled in order, but there is no ordering between sub-ranges.
+   *
+   * @param sink called with each batch of key/value of the range
+   * @return total number of key/value scanned
+   * @throw the first exception thrown by a scanning thread (fdb_exception if non retry-able or thrown by the sink),
+   * the other scanning threads are stopped as soon as possible.
+   */
+  std::size_t scan(const std::function<void(const range_view &)> &sink);
+
+private:
+  free_fdb &_db;
+  std::string _begin;
+  std::string _end;
+  scan_options _opt;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_PARALLEL_SCAN_HH
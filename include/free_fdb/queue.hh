@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_QUEUE_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_QUEUE_HH
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ffdb.hh"
+#include "subspace.hh"
+#include "tuple.hh"
+
+namespace ffdb {
+
+/**
+ * @brief Item retrieved from a fdb_queue
+ */
+struct queue_item {
+  //! position of the item in the queue (set by foundationdb at the commit of the push)
+  tuple::versionstamp id;
+  std::string value;
+};
+
+/**
+ * @brief Queue stored in a subspace, each item is a key made of the prefix of the subspace followed by a tuple
+ * encoded versionstamp.
+ *
+ * Pushing an item is done with FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_KEY: the key of the item is set by foundationdb
+ * at commit time from the commit version, a push never reads anything and producers thus never conflict with each
+ * other (nor with consumers).
+ *
+ * Consumers read the head of the queue with a snapshot read, and only add a read conflict on the items they actually
+ * dequeue: two consumers only conflict if they dequeue the same item. pop is strictly FIFO (concurrent consumers
+ * compete for the same head items), claim pick the items randomly in a window at the head of the queue which lower
+ * the probability of conflict between consumers.
+ */
+class fdb_queue {
+  struct internal;
+
+public:
+  ~fdb_queue();
+  explicit fdb_queue(subspace space);
+
+  /**
+   * @brief Append an item at the end of the queue, the item is visible by consumers once the transaction is committed.
+   * Items pushed in a same transaction are kept in the order of the push (see fdb_transaction::next_user_version).
+   *
+   * @param transaction on which the push is made
+   * @param item value to push in the queue
+   */
+  void push(fdb_transaction &transaction, std::string_view item) const;
+
+  /**
+   * @brief Dequeue the items at the head of the queue
+   *
+   * @param transaction on which the items are dequeued, the items are removed from the queue once it is committed
+   * @param max_items maximum number of items to dequeue (nothing is read nor dequeued if 0)
+   * @return dequeued items in the order of the queue, empty if the queue is empty
+   */
+  std::vector<queue_item> pop(fdb_transaction &transaction, std::size_t max_items = 1) const;
+
+  /**
+   * @brief Dequeue items randomly chosen among the first items of the queue (the ordering between the dequeued items
+   * is kept). Concurrent consumers are less likely to dequeue the same items, and thus to conflict, than with pop.
+   *
+   * @param transaction on which the items are dequeued, the items are removed from the queue once it is committed
+   * @param max_items maximum number of items to dequeue (nothing is read nor dequeued if 0)
+   * @param window number of items at the head of the queue to choose from (at least max_items, at most INT_MAX as
+   * the limit of a foundationdb range read)
+   * @return dequeued items, empty if the queue is empty
+   */
+  std::vector<queue_item> claim(fdb_transaction &transaction, std::size_t max_items, std::size_t window) const;
+
+  /**
+   * @return true if the queue is empty (snapshot read, doesn't conflict with concurrent pushes)
+   */
+  [[nodiscard]] bool empty(fdb_transaction &transaction) const;
+
+  /**
+   * @return subspace containing the items of the queue
+   */
+  [[nodiscard]] const subspace &space() const;
+
+private:
+  std::unique_ptr<internal> _impl;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_QUEUE_HH
@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_READ_CACHE_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_READ_CACHE_HH
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "ffdb.hh"
+
+namespace ffdb {
+
+/**
+ * @brief Options of a read_cache
+ */
+struct read_cache_options {
+  //! maximum number of keys cached (split evenly between the shards), least recently used keys are evicted first
+  std::size_t capacity = 10000;
+  //! number of independent shards (each with its own lock), reduce the contention between the reading threads
+  std::size_t shards = 16;
+  //! maximum number of watches the cache can hold, once reached the missed keys are read without being cached
+  std::size_t max_watches = 1000;
+};
+
+/**
+ * @brief Counters of a read_cache
+ */
+struct read_cache_stats {
+  //! reads served by the cache
+  std::uint64_t hits = 0;
+  //! reads that went to the database
+  std::uint64_t misses = 0;
+  //! cached entries not served as they were older than the minimum version requested (counted in the misses too)
+  std::uint64_t stale = 0;
+  //! entries removed because their key changed in the database (watch triggered)
+  std::uint64_t invalidations = 0;
+  //! entries removed to make room for new ones
+  std::uint64_t evictions = 0;
+  //! misses not cached because the watch budget was exhausted
+  std::uint64_t uncached = 0;
+  //! number of entries currently cached
+  std::size_t size = 0;
+};
+
+/**
+ * @brief Value returned by a read_cache
+ */
+struct cached_value {
+  //! value of the key, std::nullopt if the key is not present
+  std::optional<std::string> value;
+  //! version at which the value has been read from the database
+  std::int64_t version = 0;
+};
+
+/**
+ * @brief Read-through cache of keys rarely modified (configuration, feature flags...), in front of a free_fdb
+ * instance.
+ *
+ * A missed key is read in a transaction which also set a watch on it, the value is then cached (tagged with the read
+ * version of the transaction) until the watch is triggered by a modification of the key. Cached values are thus
+ * never older than the last modification of their key, up to the latency of the watch notification.
+ *
+ * The cache is a bounded LRU split in shards. Each cached key holds a watch (released when the key is evicted), when
+ * the watch budget is exhausted the missed keys are read from the database without being cached.
+ *
+ * @warning reads are made outside of any user transaction, they are not part of a transaction conflict ranges.
+ */
+class read_cache {
+  struct internal;
+
+public:
+  /**
+   * Cancel the watches held by the cache
+   */
+  ~read_cache();
+
+  /**
+   * @param db database the keys are read from, must outlive the cache
+   * @param opt size and watch budget of the cache
+   */
+  explicit read_cache(free_fdb &db, read_cache_options opt = {});
+
+  /**
+   * @brief Read the value of a key, from the cache if present, from the database otherwise
+   *
+   * @param key to retrieve
+   * @param min_version cached values read before this version are considered stale and read again (for instance
+   * the commit version of a modification the reader must see)
+   * @return the value (std::nullopt if not present) and the version it has been read at
+   */
+  cached_value get(std::string_view key, std::int64_t min_version = 0);
+
+  /**
+   * @brief Remove a key from the cache, the next read of it goes to the database
+   */
+  void invalidate(std::string_view key);
+
+  /**
+   * @return counters of the cache (the counters are not reset)
+   */
+  [[nodiscard]] read_cache_stats stats() const;
+
+private:
+  std::shared_ptr<internal> _impl;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_READ_CACHE_HH
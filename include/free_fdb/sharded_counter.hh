@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_SHARDED_COUNTER_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_SHARDED_COUNTER_HH
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "ffdb.hh"
+#include "subspace.hh"
+
+namespace ffdb {
+
+/**
+ * @brief Selection of the shard a sharded_counter increment is applied on
+ */
+enum class shard_selection {
+  //! each thread always increment the same shard (selected from its thread id)
+  per_thread,
+  //! a shard is randomly selected at each increment
+  random
+};
+
+/**
+ * @brief Options of a sharded_counter
+ */
+struct sharded_counter_options {
+  //! number of keys the counter is spread on
+  std::uint32_t shards = 16;
+  shard_selection selection = shard_selection::per_thread;
+};
+
+/**
+ * Represent a counter in foundationdb spread on multiple keys (shards).
+ *
+ * Contrary to fdb_counter, increments don't all target the same key: the write load is spread on the shards (which
+ * can live on different storage servers) and reading the value doesn't conflict with concurrent increments (shards
+ * are read with a snapshot read). The value of the counter is the sum of its shards.
+ *
+ * Shards are stored under the provided key followed by the tuple encoded shard index. A coalescing pass (on demand
+ * with coalesce, or in background with start_coalescing) moves the value of all the shards into the first one, in
+ * order to keep the number of key to read low.
+ */
+class sharded_counter {
+  struct internal;
+
+public:
+  ~sharded_counter();
+  explicit sharded_counter(std::string_view key, sharded_counter_options opt = {});
+
+  /**
+   * Retrieve the current value of the counter (sum of the shards, retrieved in a single snapshot range read)
+   * @param transaction from which the counter has to be retrieved
+   * @return value of the counter
+   */
+  [[nodiscard]] std::int64_t value(fdb_transaction &transaction) const;
+
+  /**
+   * Increment a given amount to one of the shard of the counter.
+   * The value is not clamped (no overflow management)
+   * Modification is taken into account after the provided transaction does a commit.
+   *
+   * @param transaction on which the action is applied
+   * @param increment amount to increment on the counter.
+   */
+  void add(fdb_transaction &transaction, std::int64_t increment = 1) const;
+
+  /**
+   * Decrement a given amount from one of the shard of the counter.
+   * The value is not clamped (no underflow management)
+   * Modification is taken into account after the provided transaction does a commit.
+   *
+   * @param transaction on which the action is applied
+   * @param decrement amount to decrement from the counter
+   */
+  void sub(fdb_transaction &transaction, std::int64_t decrement = 1) const;
+
+  /**
+   * @brief Move the value of all the shards into the first shard. Only atomic operations are used (shards are read
+   * with a snapshot read), the coalescing doesn't conflict with concurrent increments. Shards left at zero are cleared.
+   * Modification is taken into account after the provided transaction does a commit.
+   *
+   * @param transaction on which the action is applied
+   */
+  void coalesce(fdb_transaction &transaction) const;
+
+  /**
+   * @brief Start a background thread coalescing the counter at each interval (each pass is a transaction run with
+   * free_fdb::run, errors are discarded and retried at the next interval). Restart the thread if already started.
+   *
+   * @param db database on which the coalescing transactions are made, must outlive the counter (or the call of
+   * stop_coalescing)
+   * @param interval time between two coalescing passes
+   */
+  void start_coalescing(free_fdb &db, std::chrono::milliseconds interval);
+
+  /**
+   * @brief Stop the background coalescing thread (if started), called at destruction time
+   */
+  void stop_coalescing();
+
+  /**
+   * @return subspace containing the shards of the counter
+   */
+  [[nodiscard]] const subspace &shards() const;
+
+private:
+  std::unique_ptr<internal> _impl;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_SHARDED_COUNTER_HH
@@ -0,0 +1,154 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_SUBSPACE_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_SUBSPACE_HH
+
+#include <string>
+#include <string_view>
+
+#include "ffdb.hh"
+#include "tuple.hh"
+
+namespace ffdb {
+
+/**
+ * @brief Compute the first key that is not prefixed by the provided key: trailing 0xff bytes are stripped and the last
+ * remaining byte is incremented (ie: "a\xff" give "b").
+ *
+ * @return the exclusive end of the range containing every key starting with the provided key
+ * @throw fdb_exception if the key is empty or only made of 0xff bytes (no such key exists)
+ */
+inline std::string strinc(std::string_view key) {
+  auto last = key.find_last_not_of('\xff');
+  if (last == std::string_view::npos) {
+	throw fdb_exception("strinc: key must contain at least one byte different from 0xff");
+  }
+  std::string result(key.substr(0, last + 1));
+  ++result.back();
+  return result;
+}
+
+/**
+ * @brief Range of keys [begin, end[
+ */
+struct key_range {
+  std::string begin;
+  std::string end;
+};
+
+/**
+ * @brief Subspace of keys sharing the same prefix. The prefix (and the range of the subspace) are computed once at
+ * construction, child keys are encoded with the tuple layer directly after the prefix in a single allocation.
+ *
+ * Subspace are meant to be built once (at startup for instance) and reused for each transaction.
+ *
+ * @code
+ *   static const ffdb::subspace users("users");
+ *   trans->put(users.pack(42, "name"), "John");
+ *   auto all_users = trans->get_range(users);
+ * @endcode
+ */
+class subspace {
+
+public:
+  /**
+   * @param raw_prefix prefix of the subspace, used as is (not tuple encoded)
+   */
+  explicit subspace(std::string_view raw_prefix = {})
+	  : _prefix(raw_prefix), _range{_prefix, _prefix.empty() ? std::string("\xff") : strinc(_prefix)} {}
+
+  /**
+   * @brief Make a subspace which prefix is the tuple encoded elements
+   */
+  template<typename... Ts>
+  [[nodiscard]] static subspace from_tuple(const Ts &...elements) {
+	return subspace(tuple::pack(elements...));
+  }
+
+  /**
+   * @return a child subspace which prefix is the current prefix followed by the tuple encoded elements
+   */
+  template<typename... Ts>
+  [[nodiscard]] subspace sub(const Ts &...elements) const {
+	return subspace(pack(elements...));
+  }
+
+  /**
+   * @return prefix of the subspace
+   */
+  [[nodiscard]] const std::string &key() const { return _prefix; }
+
+  /**
+   * @return range containing all the keys of the subspace, [prefix, strinc(prefix)[
+   */
+  [[nodiscard]] const key_range &range() const { return _range; }
+
+  /**
+   * @return true if the key belongs to the subspace
+   */
+  [[nodiscard]] bool contains(std::string_view key) const {
+	return key.substr(0, _prefix.size()) == _prefix;
+  }
+
+  /**
+   * @return key made of the prefix followed by the tuple encoded elements
+   */
+  template<typename... Ts>
+  [[nodiscard]] std::string pack(const Ts &...elements) const {
+	std::string key;
+	key.reserve(_prefix.size() + tuple::packed_size(elements...));
+	key.append(_prefix);
+	tuple::pack_append(key, elements...);
+	return key;
+  }
+
+  /**
+   * @brief Same as pack, but the key is written in the provided buffer (re-using its capacity)
+   */
+  template<typename... Ts>
+  void pack_to(std::string &out, const Ts &...elements) const {
+	out.assign(_prefix);
+	tuple::pack_append(out, elements...);
+  }
+
+  /**
+   * @brief Decode the tuple encoded elements following the prefix in the provided key
+   * @throw fdb_exception if the key doesn't belong to the subspace or doesn't contains exactly the given types
+   */
+  template<typename... Ts>
+  [[nodiscard]] std::tuple<Ts...> unpack(std::string_view key) const {
+	if (!contains(key)) {
+	  throw fdb_exception("Subspace: key doesn't belong to the subspace");
+	}
+	return tuple::unpack<Ts...>(key.substr(_prefix.size()));
+  }
+
+private:
+  std::string _prefix;
+  key_range _range;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_SUBSPACE_HH
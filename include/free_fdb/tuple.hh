@@ -0,0 +1,543 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_TUPLE_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_TUPLE_HH
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "ffdb.hh"
+
+/**
+ * Tuple layer, encode typed elements into keys which keep the ordering of the elements, and are compatible with the
+ * official bindings (python, java, go...).
+ *
+ * Supported types:
+ * - std::nullptr_t (null), std::optional<T> (null if empty)
+ * - bool
+ * - integers (up to 64 bits)
+ * - float / double
+ * - std::string / std::string_view / const char* (unicode string)
+ * - ffdb::tuple::bytes (byte string)
+ * - ffdb::tuple::uuid
+ * - ffdb::tuple::versionstamp
+ * - std::tuple<...> (nested tuple)
+ *
+ * Types are resolved at compile time, encoding into a caller provided buffer (pack_to / pack_append) doesn't make any
+ * heap allocation.
+ *
+ * @see https://github.com/apple/foundationdb/blob/master/design/tuple.md
+ */
+namespace ffdb::tuple {
+
+/**
+ * @brief Byte string element (encoded as bytes instead of unicode string)
+ */
+struct bytes {
+  std::string_view data;
+};
+
+/**
+ * @brief 128 bits UUID element
+ */
+struct uuid {
+  std::array<std::uint8_t, 16> data{};
+
+  [[nodiscard]] bool operator==(const uuid &other) const { return data == other.data; }
+  [[nodiscard]] bool operator!=(const uuid &other) const { return data != other.data; }
+};
+
+/**
+ * @brief 96 bits versionstamp element: 10 bytes of transaction version (set by foundationdb at commit time) followed
+ * by 2 bytes of user version (used to order multiple versionstamps of a same transaction)
+ *
+ * @see https://apple.github.io/foundationdb/data-modeling.html#versionstamps
+ */
+struct versionstamp {
+  std::array<std::uint8_t, 10> transaction_version{};
+  std::uint16_t user_version = 0;
+
+  /**
+   * @return a versionstamp to be completed by foundationdb at commit time (see pack_with_versionstamp)
+   */
+  [[nodiscard]] static versionstamp incomplete(std::uint16_t user_version = 0) {
+	versionstamp v;
+	v.transaction_version.fill(0xff);
+	v.user_version = user_version;
+	return v;
+  }
+
+  [[nodiscard]] bool is_complete() const {
+	for (auto byte : transaction_version) {
+	  if (byte != 0xff) {
+		return true;
+	  }
+	}
+	return false;
+  }
+
+  [[nodiscard]] bool operator==(const versionstamp &other) const {
+	return transaction_version == other.transaction_version && user_version == other.user_version;
+  }
+  [[nodiscard]] bool operator!=(const versionstamp &other) const { return !(*this == other); }
+};
+
+namespace internal {
+
+constexpr std::uint8_t code_null = 0x00;
+constexpr std::uint8_t code_bytes = 0x01;
+constexpr std::uint8_t code_string = 0x02;
+constexpr std::uint8_t code_nested = 0x05;
+constexpr std::uint8_t code_int_zero = 0x14;
+constexpr std::uint8_t code_float = 0x20;
+constexpr std::uint8_t code_double = 0x21;
+constexpr std::uint8_t code_false = 0x26;
+constexpr std::uint8_t code_true = 0x27;
+constexpr std::uint8_t code_uuid = 0x30;
+constexpr std::uint8_t code_versionstamp = 0x33;
+constexpr std::uint8_t escape = 0xff;
+
+template<typename T>
+struct is_std_tuple : std::false_type {};
+template<typename... Ts>
+struct is_std_tuple<std::tuple<Ts...>> : std::true_type {};
+
+template<typename T>
+struct is_optional : std::false_type {};
+template<typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template<typename T>
+constexpr bool is_integer_v = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+template<typename T>
+constexpr bool is_string_v = std::is_convertible_v<const T &, std::string_view> && !std::is_same_v<T, bytes>;
+
+template<typename T>
+constexpr bool dependent_false_v = false;
+
+template<typename T>
+std::uint64_t magnitude(T value) {
+  if constexpr (std::is_signed_v<T>) {
+	if (value < 0) {
+	  return static_cast<std::uint64_t>(-(static_cast<std::int64_t>(value) + 1)) + 1;
+	}
+  }
+  return static_cast<std::uint64_t>(value);
+}
+
+inline std::size_t integer_size(std::uint64_t magnitude) {
+  std::size_t size = 0;
+  for (; magnitude != 0; magnitude >>= 8) {
+	++size;
+  }
+  return size;
+}
+
+inline std::size_t escaped_size(std::string_view data) {
+  std::size_t size = data.size() + 2;
+  for (char c : data) {
+	size += (c == '\0');
+  }
+  return size;
+}
+
+template<typename T>
+std::size_t element_size(const T &value, bool nested) {
+  if constexpr (std::is_same_v<T, std::nullptr_t>) {
+	return nested ? 2 : 1;
+  } else if constexpr (is_optional<T>::value) {
+	return value ? element_size(*value, nested) : (nested ? 2 : 1);
+  } else if constexpr (std::is_same_v<T, bool>) {
+	return 1;
+  } else if constexpr (is_integer_v<T>) {
+	return 1 + integer_size(magnitude(value));
+  } else if constexpr (std::is_same_v<T, float>) {
+	return 1 + sizeof(float);
+  } else if constexpr (std::is_same_v<T, double>) {
+	return 1 + sizeof(double);
+  } else if constexpr (std::is_same_v<T, uuid>) {
+	return 17;
+  } else if constexpr (std::is_same_v<T, versionstamp>) {
+	return 13;
+  } else if constexpr (std::is_same_v<T, bytes>) {
+	return escaped_size(value.data);
+  } else if constexpr (is_string_v<T>) {
+	return escaped_size(std::string_view(value));
+  } else if constexpr (is_std_tuple<T>::value) {
+	return 2 + std::apply([](const auto &...elements) { return (std::size_t{0} + ... + element_size(elements, true)); }, value);
+  } else {
+	static_assert(dependent_false_v<T>, "type not supported by the tuple layer");
+  }
+}
+
+/**
+ * Encode the elements in a buffer, the buffer has to be big enough to contains the encoded elements
+ */
+struct encoder {
+
+  template<typename T>
+  void encode(const T &value, bool nested) {
+	if constexpr (std::is_same_v<T, std::nullptr_t>) {
+	  put(code_null);
+	  if (nested) {
+		put(escape);
+	  }
+	} else if constexpr (is_optional<T>::value) {
+	  if (value) {
+		encode(*value, nested);
+	  } else {
+		encode(nullptr, nested);
+	  }
+	} else if constexpr (std::is_same_v<T, bool>) {
+	  put(value ? code_true : code_false);
+	} else if constexpr (is_integer_v<T>) {
+	  const std::uint64_t mag = magnitude(value);
+	  const auto size = static_cast<int>(integer_size(mag));
+	  bool negative = false;
+	  if constexpr (std::is_signed_v<T>) {
+		negative = value < 0;
+	  }
+	  // negative integers are encoded as the one's complement of their magnitude
+	  const std::uint64_t raw = negative ? ~mag : mag;
+	  put(static_cast<std::uint8_t>(code_int_zero + (negative ? -size : size)));
+	  for (int i = size - 1; i >= 0; --i) {
+		put(static_cast<std::uint8_t>(raw >> (8 * i)));
+	  }
+	} else if constexpr (std::is_same_v<T, float>) {
+	  std::uint32_t bits;
+	  std::memcpy(&bits, &value, sizeof(bits));
+	  // negative: all the bits are flipped, positive: only the sign bit is flipped
+	  bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+	  put(code_float);
+	  put_big_endian(bits, sizeof(bits));
+	} else if constexpr (std::is_same_v<T, double>) {
+	  std::uint64_t bits;
+	  std::memcpy(&bits, &value, sizeof(bits));
+	  bits = (bits & 0x8000000000000000u) ? ~bits : (bits | 0x8000000000000000u);
+	  put(code_double);
+	  put_big_endian(bits, sizeof(bits));
+	} else if constexpr (std::is_same_v<T, uuid>) {
+	  put(code_uuid);
+	  for (auto byte : value.data) {
+		put(byte);
+	  }
+	} else if constexpr (std::is_same_v<T, versionstamp>) {
+	  put(code_versionstamp);
+	  if (!value.is_complete()) {
+		++incomplete_versionstamps;
+		versionstamp_position = static_cast<std::size_t>(out - begin);
+	  }
+	  for (auto byte : value.transaction_version) {
+		put(byte);
+	  }
+	  put_big_endian(value.user_version, sizeof(value.user_version));
+	} else if constexpr (std::is_same_v<T, bytes>) {
+	  put_escaped(code_bytes, value.data);
+	} else if constexpr (is_string_v<T>) {
+	  put_escaped(code_string, std::string_view(value));
+	} else if constexpr (is_std_tuple<T>::value) {
+	  put(code_nested);
+	  std::apply([this](const auto &...elements) { (encode(elements, true), ...); }, value);
+	  put(code_null);
+	} else {
+	  static_assert(dependent_false_v<T>, "type not supported by the tuple layer");
+	}
+  }
+
+  void put(std::uint8_t byte) {
+	*out++ = static_cast<char>(byte);
+  }
+
+  void put_big_endian(std::uint64_t value, std::size_t size) {
+	for (std::size_t i = size; i > 0; --i) {
+	  put(static_cast<std::uint8_t>(value >> (8 * (i - 1))));
+	}
+  }
+
+  void put_escaped(std::uint8_t code, std::string_view data) {
+	put(code);
+	for (char c : data) {
+	  *out++ = c;
+	  if (c == '\0') {
+		put(escape);
+	  }
+	}
+	put(code_null);
+  }
+
+  char *begin;
+  char *out;
+  std::size_t incomplete_versionstamps = 0;
+  std::size_t versionstamp_position = 0;
+};
+
+/**
+ * Decode the elements from an encoded key
+ */
+struct decoder {
+
+  template<typename T>
+  T decode(bool nested) {
+	if constexpr (std::is_same_v<T, std::nullptr_t>) {
+	  expect(code_null);
+	  if (nested) {
+		expect(escape);
+	  }
+	  return nullptr;
+	} else if constexpr (is_optional<T>::value) {
+	  if (is_null(nested)) {
+		decode<std::nullptr_t>(nested);
+		return std::nullopt;
+	  }
+	  return decode<typename T::value_type>(nested);
+	} else if constexpr (std::is_same_v<T, bool>) {
+	  auto code = next();
+	  if (code != code_true && code != code_false) {
+		throw fdb_exception(fmt::format("Tuple decoding: expected a boolean, found type code {}", code));
+	  }
+	  return code == code_true;
+	} else if constexpr (is_integer_v<T>) {
+	  return decode_integer<T>();
+	} else if constexpr (std::is_same_v<T, float>) {
+	  expect(code_float);
+	  auto bits = static_cast<std::uint32_t>(get_big_endian(sizeof(std::uint32_t)));
+	  bits = (bits & 0x80000000u) ? (bits ^ 0x80000000u) : ~bits;
+	  float value;
+	  std::memcpy(&value, &bits, sizeof(value));
+	  return value;
+	} else if constexpr (std::is_same_v<T, double>) {
+	  expect(code_double);
+	  auto bits = get_big_endian(sizeof(std::uint64_t));
+	  bits = (bits & 0x8000000000000000u) ? (bits ^ 0x8000000000000000u) : ~bits;
+	  double value;
+	  std::memcpy(&value, &bits, sizeof(value));
+	  return value;
+	} else if constexpr (std::is_same_v<T, uuid>) {
+	  expect(code_uuid);
+	  uuid value;
+	  for (auto &byte : value.data) {
+		byte = next();
+	  }
+	  return value;
+	} else if constexpr (std::is_same_v<T, versionstamp>) {
+	  expect(code_versionstamp);
+	  versionstamp value;
+	  for (auto &byte : value.transaction_version) {
+		byte = next();
+	  }
+	  value.user_version = static_cast<std::uint16_t>(get_big_endian(sizeof(std::uint16_t)));
+	  return value;
+	} else if constexpr (std::is_same_v<T, std::string>) {
+	  auto code = next();
+	  if (code != code_string && code != code_bytes) {
+		throw fdb_exception(fmt::format("Tuple decoding: expected a string, found type code {}", code));
+	  }
+	  return get_escaped();
+	} else if constexpr (is_std_tuple<T>::value) {
+	  expect(code_nested);
+	  auto value = decode_nested(static_cast<T *>(nullptr));
+	  expect(code_null);
+	  return value;
+	} else {
+	  static_assert(dependent_false_v<T>, "type not supported by the tuple layer (strings are decoded as std::string)");
+	}
+  }
+
+  template<typename... Ts>
+  std::tuple<Ts...> decode_nested(std::tuple<Ts...> *) {
+	// braced initialization guarantee left to right evaluation
+	return std::tuple<Ts...>{decode<Ts>(true)...};
+  }
+
+  template<typename T>
+  T decode_integer() {
+	const auto code = next();
+	if (code < code_int_zero - 8 || code > code_int_zero + 8) {
+	  throw fdb_exception(fmt::format("Tuple decoding: expected an integer (up to 64 bits), found type code {}", code));
+	}
+	const bool negative = code < code_int_zero;
+	const std::size_t size = negative ? code_int_zero - code : code - code_int_zero;
+	std::uint64_t raw = get_big_endian(size);
+
+	if (!negative) {
+	  if (raw > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+		throw fdb_exception("Tuple decoding: integer overflow");
+	  }
+	  return static_cast<T>(raw);
+	}
+	const std::uint64_t mask = size == 8 ? ~std::uint64_t{0} : ((std::uint64_t{1} << (8 * size)) - 1);
+	const std::uint64_t mag = ~raw & mask;
+	if constexpr (std::is_signed_v<T>) {
+	  if (mag - 1 <= static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+		// -(mag - 1) - 1 avoid the overflow on the minimum value
+		return static_cast<T>(-static_cast<std::int64_t>(mag - 1) - 1);
+	  }
+	}
+	throw fdb_exception("Tuple decoding: integer overflow");
+  }
+
+  [[nodiscard]] bool is_null(bool nested) const {
+	if (pos >= data.size() || static_cast<std::uint8_t>(data[pos]) != code_null) {
+	  return false;
+	}
+	return !nested || (pos + 1 < data.size() && static_cast<std::uint8_t>(data[pos + 1]) == escape);
+  }
+
+  std::uint8_t next() {
+	if (pos >= data.size()) {
+	  throw fdb_exception("Tuple decoding: unexpected end of data");
+	}
+	return static_cast<std::uint8_t>(data[pos++]);
+  }
+
+  void expect(std::uint8_t code) {
+	if (auto found = next(); found != code) {
+	  throw fdb_exception(fmt::format("Tuple decoding: expected type code {}, found {}", code, found));
+	}
+  }
+
+  std::uint64_t get_big_endian(std::size_t size) {
+	std::uint64_t value = 0;
+	for (std::size_t i = 0; i < size; ++i) {
+	  value = (value << 8) | next();
+	}
+	return value;
+  }
+
+  std::string get_escaped() {
+	std::string value;
+	while (true) {
+	  auto c = next();
+	  if (c == code_null) {
+		if (pos < data.size() && static_cast<std::uint8_t>(data[pos]) == escape) {
+		  ++pos;
+		} else {
+		  return value;
+		}
+	  }
+	  value.push_back(static_cast<char>(c));
+	}
+  }
+
+  std::string_view data;
+  std::size_t pos = 0;
+};
+
+}// namespace internal
+
+/**
+ * @return size in bytes of the provided elements once encoded
+ */
+template<typename... Ts>
+std::size_t packed_size(const Ts &...elements) {
+  return (std::size_t{0} + ... + internal::element_size(elements, false));
+}
+
+/**
+ * @brief Encode the elements in the provided buffer (no allocation is made)
+ *
+ * @param out buffer where to write the encoded elements, it has to be at least packed_size(elements...) bytes long
+ * @return pointer after the last byte written
+ */
+template<typename... Ts>
+char *pack_to(char *out, const Ts &...elements) {
+  internal::encoder encoder{out, out};
+  (encoder.encode(elements, false), ...);
+  return encoder.out;
+}
+
+/**
+ * @brief Encode the elements at the end of the provided string (re-using its capacity, no allocation is made if the
+ * capacity is big enough)
+ */
+template<typename... Ts>
+void pack_append(std::string &out, const Ts &...elements) {
+  const auto previous_size = out.size();
+  out.resize(previous_size + packed_size(elements...));
+  pack_to(out.data() + previous_size, elements...);
+}
+
+/**
+ * @return the elements encoded as a key
+ */
+template<typename... Ts>
+std::string pack(const Ts &...elements) {
+  std::string key;
+  pack_append(key, elements...);
+  return key;
+}
+
+/**
+ * @brief Encode the elements as a key to be used with FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_KEY (or _VALUE): the
+ * position of the incomplete versionstamp is appended at the end of the key (4 bytes little endian), foundationdb
+ * replace the versionstamp by the commit version at commit time.
+ *
+ * @param prefix raw bytes prepended to the encoded elements (a subspace prefix for instance)
+ * @throw fdb_exception if the elements doesn't contains exactly one incomplete versionstamp
+ */
+template<typename... Ts>
+std::string pack_with_versionstamp(std::string_view prefix, const Ts &...elements) {
+  std::string key;
+  key.resize(prefix.size() + packed_size(elements...) + sizeof(std::uint32_t));
+  std::memcpy(key.data(), prefix.data(), prefix.size());
+
+  internal::encoder encoder{key.data(), key.data() + prefix.size()};
+  (encoder.encode(elements, false), ...);
+  if (encoder.incomplete_versionstamps != 1) {
+	throw fdb_exception(fmt::format("Tuple encoding: exactly one incomplete versionstamp expected, found {}", encoder.incomplete_versionstamps));
+  }
+  auto position = static_cast<std::uint32_t>(encoder.versionstamp_position);
+  for (std::size_t i = 0; i < sizeof(position); ++i) {
+	encoder.put(static_cast<std::uint8_t>(position >> (8 * i)));
+  }
+  return key;
+}
+
+/**
+ * @brief Decode the elements of an encoded key
+ * @return the decoded elements
+ * @throw fdb_exception if the key doesn't contains exactly the given types
+ */
+template<typename... Ts>
+std::tuple<Ts...> unpack(std::string_view key) {
+  internal::decoder decoder{key};
+  // braced initialization guarantee left to right evaluation
+  std::tuple<Ts...> elements{decoder.decode<Ts>(false)...};
+  if (decoder.pos != key.size()) {
+	throw fdb_exception("Tuple decoding: unexpected trailing data");
+  }
+  return elements;
+}
+
+}// namespace ffdb::tuple
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_TUPLE_HH
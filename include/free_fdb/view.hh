@@ -0,0 +1,220 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_VIEW_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_VIEW_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include "async.hh"
+#include "iterator.hh"
+
+namespace ffdb {
+
+/**
+ * @return a view on the provided bytes
+ */
+inline std::string_view bytes_view(const uint8_t *bytes, std::size_t length) {
+  return std::string_view(reinterpret_cast<const char *>(bytes), length);
+}
+
+/**
+ * @brief Non owning key/value pair, bytes are owned by the foundationdb future it comes from
+ */
+struct kv_view {
+  std::string_view key;
+  std::string_view value;
+};
+
+/**
+ * @brief Zero-copy result of a range selection (see fdb_transaction::get_range_view)
+ *
+ * The key/value pairs are not copied, the view keeps the foundationdb future alive and give access to its
+ * key/value array. The std::string_view retrieved from the view are valid as long as the view (or one of its copies)
+ * is alive.
+ */
+class range_view {
+
+public:
+  class const_iterator {
+  public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = kv_view;
+	using difference_type = std::ptrdiff_t;
+	using pointer = void;
+	using reference = kv_view;
+
+	const_iterator() = default;
+	explicit const_iterator(const FDBKeyValue *kv) : _kv(kv) {}
+
+	[[nodiscard]] kv_view operator*() const {
+	  return kv_view{
+		  std::string_view(static_cast<const char *>(_kv->key), _kv->key_length),
+		  std::string_view(static_cast<const char *>(_kv->value), _kv->value_length)};
+	}
+	[[nodiscard]] kv_view operator[](difference_type n) const { return *(*this + n); }
+
+	const_iterator &operator++() {
+	  ++_kv;
+	  return *this;
+	}
+	const_iterator operator++(int) { return const_iterator(_kv++); }
+	const_iterator &operator--() {
+	  --_kv;
+	  return *this;
+	}
+	const_iterator operator--(int) { return const_iterator(_kv--); }
+	const_iterator &operator+=(difference_type n) {
+	  _kv += n;
+	  return *this;
+	}
+	const_iterator &operator-=(difference_type n) {
+	  _kv -= n;
+	  return *this;
+	}
+	[[nodiscard]] const_iterator operator+(difference_type n) const { return const_iterator(_kv + n); }
+	[[nodiscard]] const_iterator operator-(difference_type n) const { return const_iterator(_kv - n); }
+	[[nodiscard]] difference_type operator-(const const_iterator &other) const { return _kv - other._kv; }
+
+	[[nodiscard]] bool operator==(const const_iterator &other) const { return _kv == other._kv; }
+	[[nodiscard]] bool operator!=(const const_iterator &other) const { return _kv != other._kv; }
+	[[nodiscard]] bool operator<(const const_iterator &other) const { return _kv < other._kv; }
+	[[nodiscard]] bool operator>(const const_iterator &other) const { return _kv > other._kv; }
+	[[nodiscard]] bool operator<=(const const_iterator &other) const { return _kv <= other._kv; }
+	[[nodiscard]] bool operator>=(const const_iterator &other) const { return _kv >= other._kv; }
+
+  private:
+	const FDBKeyValue *_kv = nullptr;
+  };
+
+  range_view() = default;
+  range_view(future_handle future, const FDBKeyValue *kv, int count, bool truncated)
+	  : _future(std::move(future)), _kv(kv), _count(count), _truncated(truncated) {}
+
+  [[nodiscard]] const_iterator begin() const { return const_iterator(_kv); }
+  [[nodiscard]] const_iterator end() const { return const_iterator(_kv + _count); }
+
+  [[nodiscard]] std::size_t size() const { return static_cast<std::size_t>(_count); }
+  [[nodiscard]] bool empty() const { return _count == 0; }
+
+  [[nodiscard]] kv_view operator[](std::size_t index) const { return begin()[index]; }
+  [[nodiscard]] kv_view front() const { return *begin(); }
+  [[nodiscard]] kv_view back() const { return *(end() - 1); }
+
+  /**
+   * @return true if the range has not been fully retrieved (limit reached), false otherwise
+   */
+  [[nodiscard]] bool truncated() const { return _truncated; }
+
+  /**
+   * @return an owning copy of the key/value pairs of the view
+   */
+  [[nodiscard]] range_result to_result() const {
+	range_result result{};
+	result.truncated = _truncated;
+	result.values.reserve(size());
+	for (const auto &[key, value] : *this) {
+	  result.values.emplace_back(fdb_result{std::string(key), std::string(value)});
+	}
+	return result;
+  }
+
+private:
+  future_handle _future;
+  const FDBKeyValue *_kv = nullptr;
+  int _count = 0;
+  bool _truncated = false;
+};
+
+/**
+ * @brief Zero-copy result of a point read (see fdb_transaction::get_view)
+ *
+ * The value is not copied, the move-only handle keeps the foundationdb future alive and give access to the value bytes.
+ * The std::string_view retrieved from the handle is valid as long as the handle is alive.
+ */
+class value_view {
+
+public:
+  ~value_view() {
+	if (_owned) {
+	  fdb_future_destroy(_owned);
+	}
+  }
+  value_view() = default;
+  value_view(const value_view &) = delete;
+  value_view &operator=(const value_view &) = delete;
+
+  value_view(value_view &&other) noexcept
+	  : _owned(std::exchange(other._owned, nullptr)), _shared(std::move(other._shared)), _value(other._value), _present(other._present) {}
+
+  value_view &operator=(value_view &&other) noexcept {
+	if (this != &other) {
+	  if (_owned) {
+		fdb_future_destroy(_owned);
+	  }
+	  _owned = std::exchange(other._owned, nullptr);
+	  _shared = std::move(other._shared);
+	  _value = other._value;
+	  _present = other._present;
+	}
+	return *this;
+  }
+
+  /**
+   * @param future owned by the view, destroyed with it (blocking read)
+   */
+  value_view(FDBFuture *future, const uint8_t *value, int length, bool present)
+	  : _owned(future), _value(reinterpret_cast<const char *>(value), present ? length : 0), _present(present) {}
+
+  /**
+   * @param future shared with the asynchronous result the view is retrieved from
+   */
+  value_view(future_handle future, const uint8_t *value, int length, bool present)
+	  : _shared(std::move(future)), _value(reinterpret_cast<const char *>(value), present ? length : 0), _present(present) {}
+
+  /**
+   * @return true if the key has been found, false otherwise
+   */
+  [[nodiscard]] bool has_value() const { return _present; }
+  [[nodiscard]] explicit operator bool() const { return _present; }
+
+  /**
+   * @return bytes of the value found, empty if the key has not been found
+   */
+  [[nodiscard]] std::string_view value() const { return _value; }
+  [[nodiscard]] std::string_view operator*() const { return _value; }
+
+private:
+  FDBFuture *_owned = nullptr;
+  future_handle _shared;
+  std::string_view _value;
+  bool _present = false;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_VIEW_HH
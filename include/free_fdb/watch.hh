@@ -0,0 +1,148 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_WATCH_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_WATCH_HH
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ffdb.hh"
+
+namespace ffdb {
+
+/**
+ * @brief foundationdb error code of a watch set beyond the watch limit (see free_fdb::set_max_watches)
+ */
+constexpr fdb_error_t too_many_watches = 1032;
+
+/**
+ * @brief Options of a watcher
+ */
+struct watcher_options {
+  //! maximum number of keys watched at once, watch() throws beyond it (foundationdb limits the watches of a database
+  //! to 10000 by default, see free_fdb::set_max_watches)
+  std::size_t max_watches = 10000;
+  //! maximum number of watches armed by the same transaction
+  std::size_t max_batch = 100;
+  //! delay before re-arming the watches after a too_many_watches error, or after a failed arming transaction
+  std::chrono::milliseconds retry_delay{1000};
+  //! called (on the watcher thread) with the key and the error code when a watch failed, the watch is then re-armed
+  std::function<void(const std::string &key, fdb_error_t error)> on_error{};
+};
+
+class watch_handle;
+
+/**
+ * @brief Event-driven notification of the modification of keys, replacing the polling of the keys.
+ *
+ * The watches are armed by a background thread, many watches being armed by the same transaction (the transactions
+ * are taken from the transaction pool of the free_fdb instance). When a watch is triggered, it is re-armed before its
+ * callback is called: a modification made after the call of the callback is always notified.
+ *
+ * Callbacks are called on the watcher thread, they should not block for long (the other watches are re-armed by the
+ * same thread).
+ *
+ * @warning a callback can be called without the value of its key being modified (modification reverted before the
+ * notification, or error of the watch), and successive modifications can be notified only once.
+ *
+ * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_transaction_watch
+ */
+class watcher {
+  friend class watch_handle;
+  struct internal;
+
+public:
+  /**
+   * Cancel all the watches and stop the watcher thread
+   */
+  ~watcher();
+
+  /**
+   * @param db database on which the keys are watched, must outlive the watcher
+   * @param opt watch limit and error management of the watcher
+   */
+  explicit watcher(free_fdb &db, watcher_options opt = {});
+
+  /**
+   * @brief Call the callback each time the provided key is modified, until the returned handle is cancelled or
+   * destroyed. The watch is armed asynchronously, shortly after the call (see watch_handle::is_armed), the
+   * modifications made before are not notified.
+   *
+   * @param key to watch
+   * @param callback called with the key on the watcher thread, exceptions thrown by the callback are discarded
+   * @return handle of the watch
+   * @throw fdb_exception with the too_many_watches error code if the maximum number of watches of the watcher is
+   * reached
+   */
+  [[nodiscard]] watch_handle watch(std::string_view key, std::function<void(const std::string &)> callback);
+
+  /**
+   * @return number of keys currently watched
+   */
+  [[nodiscard]] std::size_t size() const;
+
+private:
+  std::shared_ptr<internal> _impl;
+};
+
+/**
+ * @brief RAII handle on a watch, the key stops being watched when the handle is cancelled or destroyed
+ */
+class watch_handle {
+  friend class watcher;
+
+public:
+  ~watch_handle();
+  watch_handle() = default;
+  watch_handle(const watch_handle &) = delete;
+  watch_handle &operator=(const watch_handle &) = delete;
+  watch_handle(watch_handle &&other) noexcept;
+  watch_handle &operator=(watch_handle &&other) noexcept;
+
+  /**
+   * @brief Stop watching the key. Once returned, the callback is not called anymore (if called from another thread
+   * than the watcher thread, wait for the callback to return if it is being called).
+   */
+  void cancel();
+
+  /**
+   * @return true if the watch is set in foundationdb (modifications of the key are notified)
+   */
+  [[nodiscard]] bool is_armed() const;
+
+private:
+  watch_handle(std::weak_ptr<watcher::internal> w, std::uint64_t id) : _watcher(std::move(w)), _id(id) {}
+
+  std::weak_ptr<watcher::internal> _watcher;
+  std::uint64_t _id = 0;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_WATCH_HH
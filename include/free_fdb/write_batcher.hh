@@ -0,0 +1,109 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_FREE_FDB_WRITE_BATCHER_HH
+#define FREE_FDB_INCLUDE_FREE_FDB_WRITE_BATCHER_HH
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string_view>
+
+#include "ffdb.hh"
+
+namespace ffdb {
+
+/**
+ * @brief Options of a write_batcher
+ */
+struct batcher_options {
+  //! a batch is committed as soon as its estimated size (keys, values and the overhead counted by foundationdb) reach
+  //! this size, at most 9MB (foundationdb transactions are limited to 10MB, and should be kept under 1MB for performance)
+  std::size_t max_batch_bytes = 512 * 1024;
+  //! a batch is committed at the latest after this delay (from the first operation of the batch)
+  std::chrono::microseconds max_batch_delay{1000};
+  //! maximum number of batches being committed at the same time
+  unsigned max_in_flight = 8;
+};
+
+/**
+ * @brief Coalesce the writes made by multiple threads into large transactions.
+ *
+ * Operations (put, del, del_range, atomic_op) are pushed in a lock-free multi-producer queue, and packed by a batching
+ * thread into transactions up to a size or time budget. Several batches are committed concurrently. Each operation
+ * returns a future which is completed when its batch is committed (or failed, if the commit failed with a non
+ * retry-able error). Retry-able errors are retried using foundationdb backoff (fdb_transaction::on_error).
+ *
+ * Writing through the batcher cost a single commit (and read version) per batch instead of one per write.
+ *
+ * @warning as batches are committed concurrently, operations from different batches may be applied in any order.
+ * Operations that have to be ordered have to wait for the completion of the previous ones (or use max_in_flight = 1).
+ * As for atomic operations, an operation may be applied twice if the commit result is unknown (commit_unknown_result).
+ */
+class write_batcher {
+  struct internal;
+
+public:
+  /**
+   * Commit all the pending operations and wait for the completion of the in flight batches
+   */
+  ~write_batcher();
+
+  /**
+   * @param db database on which the batches are committed, must outlive the batcher
+   * @param opt size and time budget of the batches
+   * @throw fdb_exception if max_in_flight is 0, or if max_batch_bytes is 0 or greater than 9MB
+   */
+  explicit write_batcher(free_fdb &db, batcher_options opt = {});
+
+  /**
+   * @brief Insert (or replace) a key / value pair
+   * @return future completed when the operation is committed
+   */
+  std::future<void> put(std::string_view key, std::string_view value);
+
+  /**
+   * @brief Remove a key
+   * @return future completed when the operation is committed
+   */
+  std::future<void> del(std::string_view key);
+
+  /**
+   * @brief Remove the range of key [begin, end[
+   * @return future completed when the operation is committed
+   */
+  std::future<void> del_range(std::string_view begin, std::string_view end);
+
+  /**
+   * @brief Apply an atomic operation on a key (see fdb_transaction::atomic_op)
+   * @return future completed when the operation is committed
+   */
+  std::future<void> atomic_op(std::string_view key, std::string_view param, FDBMutationType operation);
+
+private:
+  std::unique_ptr<internal> _impl;
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_FREE_FDB_WRITE_BATCHER_HH
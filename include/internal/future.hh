@@ -24,6 +24,10 @@
 #ifndef FREE_FDB_INCLUDE_INTERNAL_FUTURE_HH
 #define FREE_FDB_INCLUDE_INTERNAL_FUTURE_HH
 
+#include <functional>
+#include <memory>
+#include <utility>
+
 #include <free_fdb/ffdb.hh>
 
 namespace ffdb {
@@ -31,9 +35,31 @@ namespace ffdb {
 static void check_fdb_code(fdb_error_t error) {
   if (error != 0) {
 	if (fdb_error_predicate(FDBErrorPredicate::FDB_ERROR_PREDICATE_RETRYABLE, error)) {
-	  throw transaction_exception(fmt::format("Future, Non retry-able error : {}", fdb_get_error(error)));
+	  throw transaction_exception(fmt::format("Future, Retry-able error : {}", fdb_get_error(error)), error);
+	}
+	throw fdb_exception(fmt::format("Future, Other error : {}", fdb_get_error(error)), error);
+  }
+}
+
+/**
+ * Register a callback to be called as soon as the provided future is ready. The callback is executed by the network
+ * thread, or directly by the calling thread if the future is already ready.
+ * Exceptions cannot go through the network thread, those thrown by the callback are discarded.
+ *
+ * @see https://apple.github.io/foundationdb/api-c.html#c.fdb_future_set_callback
+ */
+inline void set_future_callback(FDBFuture *fut, std::function<void()> callback) {
+  auto *parameter = new std::function<void()>(std::move(callback));
+  auto trampoline = [](FDBFuture *, void *param) {
+	std::unique_ptr<std::function<void()>> cb(static_cast<std::function<void()> *>(param));
+	try {
+	  (*cb)();
+	} catch (...) {
 	}
-	throw fdb_exception(fmt::format("Future, Other error : {}", fdb_get_error(error)));
+  };
+  if (auto error = fdb_future_set_callback(fut, trampoline, parameter); error != 0) {
+	delete parameter;
+	throw fdb_exception(fmt::format("Error on future callback registration : {}", fdb_get_error(error)), error);
   }
 }
 
@@ -46,16 +72,37 @@ public:
   }
   fdb_future(const fdb_future &) = delete;
 
+  fdb_future(fdb_future &&other) noexcept : _data(std::exchange(other._data, nullptr)) {
+  }
+
   explicit fdb_future(FDBFuture *fut) : _data(fut) {
   }
 
+  [[nodiscard]] bool is_ready() const {
+	return _data && fdb_future_is_ready(_data);
+  }
+
+  /**
+   * Non-blocking alternative to get, the handler is called with the future as soon as it is ready.
+   * @warning the fdb_future has to outlive the call of the handler
+   */
+  template<typename Handler>
+  void on_ready(Handler &&handler) {
+	if (!_data) {
+	  throw fdb_exception("Error: Future data is null and thus cant be awaited.");
+	}
+	set_future_callback(_data, [data = _data, handler = std::forward<Handler>(handler)]() mutable {
+	  handler(data);
+	});
+  }
+
   template<typename Handler>
   auto get(Handler &&handler) {
 	if (!_data) {
 	  throw fdb_exception("Error: Future data is null and thus cant be awaited.");
 	}
 	if (auto error = fdb_future_block_until_ready(_data); error != 0) {
-	  throw fdb_exception(fmt::format("Error on future block : {}", fdb_get_error(error)));
+	  throw fdb_exception(fmt::format("Error on future block : {}", fdb_get_error(error)), error);
 	}
 	check_fdb_code(fdb_future_get_error(_data));
 	return std::forward<Handler>(handler)(_data);
@@ -65,6 +112,13 @@ public:
 	get([](FDB_future *) { return std::optional<fdb_result>{}; });
   }
 
+  /**
+   * @return the future, which is not destroyed by this object anymore
+   */
+  [[nodiscard]] FDBFuture *release() {
+	return std::exchange(_data, nullptr);
+  }
+
 private:
   FDBFuture *_data;
 };
@@ -0,0 +1,120 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FREE_FDB_INCLUDE_INTERNAL_MPMC_RING_HH
+#define FREE_FDB_INCLUDE_INTERNAL_MPMC_RING_HH
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace ffdb {
+
+/**
+ * Bounded lock-free multi-producer multi-consumer ring (Dmitry Vyukov's algorithm), each cell has a sequence number
+ * telling if it is ready to be written or read for the current lap of the ring.
+ *
+ * @tparam T trivially copyable type stored in the ring
+ */
+template<typename T>
+class mpmc_ring {
+
+  struct cell {
+	std::atomic<std::size_t> sequence;
+	T data;
+  };
+
+public:
+  /**
+   * @param capacity maximum number of elements in the ring, rounded up to a power of 2
+   */
+  explicit mpmc_ring(std::size_t capacity) {
+	std::size_t size = 1;
+	while (size < capacity) {
+	  size <<= 1;
+	}
+	_mask = size - 1;
+	_cells = std::make_unique<cell[]>(size);
+	for (std::size_t i = 0; i < size; ++i) {
+	  _cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+  }
+
+  /**
+   * @return false if the ring is full
+   */
+  bool try_push(T data) {
+	std::size_t position = _enqueue.load(std::memory_order_relaxed);
+	while (true) {
+	  cell &c = _cells[position & _mask];
+	  const std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+	  const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+	  if (diff == 0) {
+		if (_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+		  c.data = data;
+		  c.sequence.store(position + 1, std::memory_order_release);
+		  return true;
+		}
+	  } else if (diff < 0) {
+		return false;
+	  } else {
+		position = _enqueue.load(std::memory_order_relaxed);
+	  }
+	}
+  }
+
+  /**
+   * @return false if the ring is empty
+   */
+  bool try_pop(T &data) {
+	std::size_t position = _dequeue.load(std::memory_order_relaxed);
+	while (true) {
+	  cell &c = _cells[position & _mask];
+	  const std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+	  const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+	  if (diff == 0) {
+		if (_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+		  data = c.data;
+		  c.sequence.store(position + _mask + 1, std::memory_order_release);
+		  return true;
+		}
+	  } else if (diff < 0) {
+		return false;
+	  } else {
+		position = _dequeue.load(std::memory_order_relaxed);
+	  }
+	}
+  }
+
+private:
+  std::unique_ptr<cell[]> _cells;
+  std::size_t _mask = 0;
+
+  // producers and consumers positions are kept on separate cache lines
+  alignas(64) std::atomic<std::size_t> _enqueue{0};
+  alignas(64) std::atomic<std::size_t> _dequeue{0};
+};
+
+}// namespace ffdb
+
+#endif//FREE_FDB_INCLUDE_INTERNAL_MPMC_RING_HH
@@ -0,0 +1,69 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FREE_FDB_INCLUDE_INTERNAL_RECORDER_HH
+#define FREE_FDB_INCLUDE_INTERNAL_RECORDER_HH
+
+#include <chrono>
+#include <cstdint>
+
+#include <free_fdb/metrics.hh>
+
+namespace ffdb::metrics {
+
+struct thread_block;
+
+/**
+ * Recording of the metrics by the instrumented operations, each thread records in its own block of counters (written
+ * only by the thread, read by take_snapshot) without lock nor atomic read-modify-write.
+ */
+struct recorder {
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @return start time of an operation, a null time point if the metrics are disabled
+   */
+  static clock::time_point start();
+
+  /**
+   * Record the latency of an operation started at the provided time (nothing is recorded for a null time point)
+   */
+  static void record(operation op, clock::time_point start);
+
+  static void add(counter c, std::uint64_t value);
+
+  /**
+   * @return aggregation of the blocks of all the threads
+   */
+  static snapshot collect();
+
+  /**
+   * Add the metrics of the block of a thread to the snapshot
+   */
+  static void accumulate(snapshot &s, const thread_block &block);
+};
+
+}// namespace ffdb::metrics
+
+#endif//FREE_FDB_INCLUDE_INTERNAL_RECORDER_HH
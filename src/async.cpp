@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <internal/future.hh>
+
+#include <free_fdb/ffdb.hh>
+
+namespace ffdb {
+
+fdb_async_base::fdb_async_base(FDBFuture *future) : _future(future, [](FDBFuture *f) {
+  if (f) {
+	fdb_future_destroy(f);
+  }
+}) {
+}
+
+bool fdb_async_base::is_ready() const {
+  return _future && fdb_future_is_ready(_future.get());
+}
+
+void fdb_async_base::cancel() {
+  if (_future) {
+	fdb_future_cancel(_future.get());
+  }
+}
+
+void fdb_async_base::wait() const {
+  if (!_future) {
+	throw fdb_exception("Error: Future data is null and thus cant be awaited.");
+  }
+  if (auto error = fdb_future_block_until_ready(_future.get()); error != 0) {
+	throw fdb_exception(fmt::format("Error on future block : {}", fdb_get_error(error)), error);
+  }
+  check_fdb_code(fdb_future_get_error(_future.get()));
+}
+
+void fdb_async_base::on_ready(std::function<void()> callback) const {
+  if (!_future) {
+	throw fdb_exception("Error: Future data is null and thus cant be awaited.");
+  }
+  set_future_callback(_future.get(), std::move(callback));
+}
+
+}// namespace ffdb
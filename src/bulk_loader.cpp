@@ -0,0 +1,377 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <free_fdb/bulk_loader.hh>
+
+namespace {
+
+//! cap of the estimated size of a transaction, kept below the 10MB limit of foundationdb
+constexpr std::size_t max_transaction_bytes = 9 * 1000 * 1000;
+//! estimated overhead of foundationdb for each mutation of a transaction
+constexpr std::size_t mutation_overhead = 32;
+
+/**
+ * Estimate the size of a put in a transaction as counted by foundationdb: the mutation (key, value and overhead) and
+ * the write conflict range [key, key\x00[
+ */
+std::size_t transaction_bytes(std::string_view key, std::string_view value) {
+  return key.size() + value.size() + mutation_overhead + 2 * key.size() + 1;
+}
+
+std::uint32_t read_length(const char *data) {
+  const auto *bytes = reinterpret_cast<const unsigned char *>(data);
+  return std::uint32_t(bytes[0]) | (std::uint32_t(bytes[1]) << 8) | (std::uint32_t(bytes[2]) << 16) | (std::uint32_t(bytes[3]) << 24);
+}
+
+std::string encode_offset(std::uint64_t offset) {
+  std::string value(sizeof(offset), '\0');
+  std::memcpy(value.data(), &offset, sizeof(offset));
+  return value;
+}
+
+std::uint64_t decode_offset(std::string_view value) {
+  std::uint64_t offset = 0;
+  std::memcpy(&offset, value.data(), std::min(value.size(), sizeof(offset)));
+  return offset;
+}
+
+struct record {
+  std::string_view key;
+  std::string_view value;
+  //! offset of the next record
+  std::size_t next;
+};
+
+}// namespace
+
+namespace ffdb {
+
+struct bulk_loader::internal {
+
+  internal(free_fdb &db, const std::string &path, load_options opt) : db(db), opt(std::move(opt)) {
+	this->opt.max_batch_bytes = std::clamp<std::size_t>(this->opt.max_batch_bytes, 1, max_transaction_bytes);
+	this->opt.concurrency = std::max(1u, this->opt.concurrency);
+	if (this->opt.fixed_key_size == 0 && this->opt.fixed_value_size > 0) {
+	  throw fdb_exception("bulk_loader: fixed_value_size is set without fixed_key_size");
+	}
+	if (this->opt.partitions == 0) {
+	  this->opt.partitions = this->opt.concurrency * 4;
+	}
+	map(path);
+	split();
+  }
+
+  ~internal() {
+	if (data != nullptr && size > 0) {
+	  ::munmap(const_cast<char *>(data), size);
+	}
+  }
+
+  void map(const std::string &path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+	  throw fdb_exception(fmt::format("bulk_loader: cannot open {}: {}", path, std::strerror(errno)));
+	}
+	struct stat st {};
+	if (::fstat(fd, &st) != 0) {
+	  ::close(fd);
+	  throw fdb_exception(fmt::format("bulk_loader: cannot stat {}: {}", path, std::strerror(errno)));
+	}
+	size = static_cast<std::size_t>(st.st_size);
+	if (size > 0) {
+	  void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	  if (mapping == MAP_FAILED) {
+		::close(fd);
+		throw fdb_exception(fmt::format("bulk_loader: cannot map {}: {}", path, std::strerror(errno)));
+	  }
+	  ::madvise(mapping, size, MADV_SEQUENTIAL);
+	  data = static_cast<const char *>(mapping);
+	}
+	::close(fd);
+  }
+
+  [[nodiscard]] bool fixed_size() const {
+	return opt.fixed_key_size > 0;
+  }
+
+  [[nodiscard]] record parse(std::size_t offset) const {
+	if (fixed_size()) {
+	  const std::size_t record_size = opt.fixed_key_size + opt.fixed_value_size;
+	  if (offset + record_size > size) {
+		throw fdb_exception(fmt::format("bulk_loader: truncated record at offset {}", offset));
+	  }
+	  return record{
+		  std::string_view(data + offset, opt.fixed_key_size),
+		  std::string_view(data + offset + opt.fixed_key_size, opt.fixed_value_size),
+		  offset + record_size};
+	}
+	auto field = [this](std::size_t &cursor) {
+	  if (cursor + sizeof(std::uint32_t) > size) {
+		throw fdb_exception(fmt::format("bulk_loader: truncated record at offset {}", cursor));
+	  }
+	  const std::size_t length = read_length(data + cursor);
+	  cursor += sizeof(std::uint32_t);
+	  if (cursor + length > size) {
+		throw fdb_exception(fmt::format("bulk_loader: truncated record at offset {}", cursor));
+	  }
+	  std::string_view result(data + cursor, length);
+	  cursor += length;
+	  return result;
+	};
+	std::size_t cursor = offset;
+	auto key = field(cursor);
+	auto value = field(cursor);
+	return record{key, value, cursor};
+  }
+
+  /**
+   * Compute the boundaries (record offsets) of the partitions, each partition is about size / partitions bytes
+   */
+  void split() {
+	boundaries.push_back(0);
+	const std::size_t target = std::max<std::size_t>(1, size / opt.partitions);
+
+	if (fixed_size()) {
+	  const std::size_t record_size = opt.fixed_key_size + opt.fixed_value_size;
+	  if (size % record_size != 0) {
+		throw fdb_exception("bulk_loader: input size is not a multiple of the record size");
+	  }
+	  const std::size_t records_per_partition = std::max<std::size_t>(1, target / record_size);
+	  for (std::size_t offset = records_per_partition * record_size; offset < size; offset += records_per_partition * record_size) {
+		boundaries.push_back(offset);
+	  }
+	} else {
+	  // only the lengths are read to find the record boundaries
+	  std::size_t next_boundary = target;
+	  for (std::size_t offset = 0; offset < size; offset = parse(offset).next) {
+		if (offset >= next_boundary) {
+		  boundaries.push_back(offset);
+		  next_boundary = offset + target;
+		}
+	  }
+	}
+	boundaries.push_back(size);
+  }
+
+  [[nodiscard]] std::size_t partition_count() const {
+	return boundaries.size() - 1;
+  }
+
+  [[nodiscard]] std::string layout() const {
+	return tuple::pack(static_cast<std::uint64_t>(size), static_cast<std::uint64_t>(partition_count()));
+  }
+
+  /**
+   * Check the checkpoint has been made on the same input and partitioning, and retrieve the progression of each
+   * partition
+   */
+  std::vector<std::size_t> read_checkpoint() {
+	std::vector<std::size_t> starts(boundaries.begin(), boundaries.end() - 1);
+	if (!opt.checkpoint) {
+	  return starts;
+	}
+	db.run([this, &starts](fdb_transaction &trans) {
+	  const auto &checkpoint = *opt.checkpoint;
+	  auto stored_layout = trans.get_view(checkpoint.pack("layout"));
+	  if (stored_layout && stored_layout.value() != layout()) {
+		throw fdb_exception("bulk_loader: the checkpoint has been made with a different input or partitioning");
+	  }
+	  if (!stored_layout) {
+		trans.put(checkpoint.pack("layout"), layout());
+		return;
+	  }
+	  auto progress = checkpoint.sub("partition");
+	  for (const auto &kv : trans.get_range_view(progress)) {
+		auto [partition] = progress.unpack<std::uint64_t>(kv.key);
+		if (partition < starts.size()) {
+		  starts[partition] = decode_offset(kv.value);
+		}
+	  }
+	});
+	return starts;
+  }
+
+  /**
+   * Load the records in [begin, end[ by transactions of max_batch_bytes
+   */
+  void load_partition(std::size_t partition, std::size_t begin, std::size_t end) {
+	std::optional<std::string> checkpoint_key;
+	if (opt.checkpoint) {
+	  checkpoint_key = opt.checkpoint->pack("partition", static_cast<std::uint64_t>(partition));
+	}
+	auto trans = db.make_transaction();
+
+	while (begin < end && !failed.load(std::memory_order_relaxed)) {
+	  std::size_t batch_end = begin;
+	  std::size_t batch_bytes = 0;
+	  std::size_t batch_transaction_bytes = 0;
+	  std::size_t batch_records = 0;
+	  while (batch_end < end && batch_transaction_bytes < opt.max_batch_bytes) {
+		auto r = parse(batch_end);
+		batch_bytes += r.key.size() + r.value.size();
+		batch_transaction_bytes += transaction_bytes(r.key, r.value);
+		batch_end = r.next;
+		++batch_records;
+	  }
+
+	  while (true) {
+		try {
+		  for (std::size_t offset = begin; offset < batch_end;) {
+			auto r = parse(offset);
+			trans->put(r.key, r.value);
+			offset = r.next;
+		  }
+		  if (checkpoint_key) {
+			trans->put(*checkpoint_key, encode_offset(batch_end));
+		  }
+		  trans->commit();
+		  break;
+		} catch (const fdb_exception &e) {
+		  if (e.code() == 0) {
+			throw;
+		  }
+		  trans->on_error(e.code());
+		  retries.fetch_add(1, std::memory_order_relaxed);
+		}
+	  }
+	  trans->reset();
+
+	  records.fetch_add(batch_records, std::memory_order_relaxed);
+	  bytes.fetch_add(batch_bytes, std::memory_order_relaxed);
+	  transactions.fetch_add(1, std::memory_order_relaxed);
+	  begin = batch_end;
+	}
+  }
+
+  free_fdb &db;
+  load_options opt;
+
+  const char *data = nullptr;
+  std::size_t size = 0;
+  //! record offsets delimiting the partitions (first is 0, last is the size of the input)
+  std::vector<std::size_t> boundaries;
+
+  std::atomic<bool> failed{false};
+  std::atomic<std::size_t> records{0};
+  std::atomic<std::size_t> bytes{0};
+  std::atomic<std::size_t> transactions{0};
+  std::atomic<std::size_t> retries{0};
+};
+
+bulk_loader::~bulk_loader() = default;
+
+bulk_loader::bulk_loader(free_fdb &db, const std::string &input_path, load_options opt)
+	: _impl(std::make_unique<internal>(db, input_path, std::move(opt))) {
+}
+
+load_stats bulk_loader::load() {
+  auto starts = _impl->read_checkpoint();
+  const auto &boundaries = _impl->boundaries;
+
+  load_stats stats;
+  std::vector<std::size_t> remaining;
+  for (std::size_t partition = 0; partition < starts.size(); ++partition) {
+	if (starts[partition] < boundaries[partition + 1]) {
+	  remaining.push_back(partition);
+	} else {
+	  ++stats.resumed_partitions;
+	}
+  }
+
+  _impl->failed = false;
+  _impl->records = 0;
+  _impl->bytes = 0;
+  _impl->transactions = 0;
+  _impl->retries = 0;
+
+  std::atomic<std::size_t> next_partition{0};
+  std::exception_ptr first_error;
+  std::mutex error_mutex;
+
+  std::vector<std::thread> workers;
+  const auto thread_count = std::min<std::size_t>(_impl->opt.concurrency, remaining.size());
+  workers.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+	workers.emplace_back([&]() {
+	  try {
+		for (auto index = next_partition++; index < remaining.size() && !_impl->failed; index = next_partition++) {
+		  const auto partition = remaining[index];
+		  _impl->load_partition(partition, starts[partition], boundaries[partition + 1]);
+		}
+	  } catch (...) {
+		std::lock_guard lock(error_mutex);
+		if (!first_error) {
+		  first_error = std::current_exception();
+		}
+		_impl->failed = true;
+	  }
+	});
+  }
+  for (auto &worker : workers) {
+	worker.join();
+  }
+  if (first_error) {
+	std::rethrow_exception(first_error);
+  }
+
+  stats.records = _impl->records;
+  stats.bytes = _impl->bytes;
+  stats.transactions = _impl->transactions;
+  stats.retries = _impl->retries;
+  return stats;
+}
+
+void bulk_loader::clear_checkpoint() {
+  if (_impl->opt.checkpoint) {
+	_impl->db.run([this](fdb_transaction &trans) { trans.del_range(*_impl->opt.checkpoint); });
+  }
+}
+
+std::size_t bulk_loader::partitions() const {
+  return _impl->partition_count();
+}
+
+void bulk_loader::encode_record(std::string &out, std::string_view key, std::string_view value) {
+  auto append_length = [&out](std::size_t length) {
+	for (std::size_t i = 0; i < sizeof(std::uint32_t); ++i) {
+	  out.push_back(static_cast<char>((length >> (8 * i)) & 0xff));
+	}
+  };
+  append_length(key.size());
+  out.append(key);
+  append_length(value.size());
+  out.append(value);
+}
+
+}// namespace ffdb
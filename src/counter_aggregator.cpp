@@ -0,0 +1,252 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <free_fdb/counter_aggregator.hh>
+
+namespace {
+
+//! identifier of the aggregators, never re-used (contrary to their address)
+std::atomic<std::uint64_t> next_aggregator_id{1};
+
+/**
+ * Increment slot, each one is on its own cache line in order to avoid false sharing between the incrementing threads
+ * and the flush thread
+ */
+struct alignas(64) slot {
+  std::atomic<std::int64_t> value{0};
+};
+
+/**
+ * Slots of a thread for an aggregator, one per counter
+ */
+struct thread_block {
+  explicit thread_block(std::size_t counters) : slots(std::make_unique<slot[]>(counters)) {}
+
+  std::unique_ptr<slot[]> slots;
+};
+
+/**
+ * Blocks of the current thread, by aggregator id. The last used one is cached as the same aggregator is generally
+ * used by a thread.
+ */
+struct thread_blocks {
+  std::uint64_t last_id = 0;
+  thread_block *last_block = nullptr;
+  std::unordered_map<std::uint64_t, thread_block *> blocks;
+};
+
+thread_local thread_blocks local_blocks;
+
+}// namespace
+
+namespace ffdb {
+
+struct counter_aggregator::internal {
+
+  internal(free_fdb &db, aggregator_options opt) : db(db), opt(opt), pending(opt.max_counters, 0) {
+	keys.reserve(opt.max_counters);
+  }
+
+  /**
+   * @return slots of the current thread, the block is created (under lock) at the first increment of the thread
+   */
+  thread_block &local_block() {
+	if (local_blocks.last_id == id) {
+	  return *local_blocks.last_block;
+	}
+	auto &block = local_blocks.blocks[id];
+	if (!block) {
+	  std::lock_guard lock(blocks_mutex);
+	  block = blocks.emplace_back(std::make_unique<thread_block>(opt.max_counters)).get();
+	}
+	local_blocks.last_id = id;
+	local_blocks.last_block = block;
+	return *block;
+  }
+
+  /**
+   * Move the increments from the thread slots into the pending increments
+   */
+  void collect() {
+	std::lock_guard lock(blocks_mutex);
+	const std::size_t counters = registered.load(std::memory_order_acquire);
+	for (auto &block : blocks) {
+	  for (std::size_t i = 0; i < counters; ++i) {
+		if (block->slots[i].value.load(std::memory_order_relaxed) != 0) {
+		  pending[i] += block->slots[i].value.exchange(0, std::memory_order_relaxed);
+		}
+	  }
+	}
+  }
+
+  void flush() {
+	std::lock_guard lock(flush_mutex);
+	collect();
+
+	auto trans = db.make_transaction();
+	trans->set_timeout(opt.flush_timeout);
+
+	const std::size_t counters = registered.load(std::memory_order_acquire);
+	while (true) {
+	  try {
+		bool empty = true;
+		for (std::size_t i = 0; i < counters; ++i) {
+		  if (pending[i] != 0) {
+			trans->atomic_op(
+				keys[i],
+				std::string_view(reinterpret_cast<const char *>(&pending[i]), sizeof(std::int64_t)),
+				FDBMutationType::FDB_MUTATION_TYPE_ADD);
+			empty = false;
+		  }
+		}
+		if (empty) {
+		  return;
+		}
+		trans->commit();
+		std::fill(pending.begin(), pending.end(), 0);
+		return;
+	  } catch (const fdb_exception &e) {
+		if (e.code() == 0) {
+		  throw;
+		}
+		// throws if the error is not retry-able (the timeout included), pending increments are kept
+		trans->on_error(e.code());
+	  }
+	}
+  }
+
+  void flush_loop() {
+	std::unique_lock lock(stop_mutex);
+	while (!cv.wait_for(lock, opt.flush_interval, [this] { return stopped; })) {
+	  lock.unlock();
+	  // increments are kept and flushed at the next interval
+	  flush_or_report();
+	  lock.lock();
+	}
+  }
+
+  void flush_or_report() {
+	try {
+	  flush();
+	} catch (const fdb_exception &e) {
+	  report(e);
+	} catch (const std::exception &e) {
+	  report(fdb_exception(e.what()));
+	}
+  }
+
+  void report(const fdb_exception &error) const {
+	if (!opt.on_flush_error) {
+	  return;
+	}
+	try {
+	  opt.on_flush_error(error);
+	} catch (...) {
+	}
+  }
+
+  free_fdb &db;
+  aggregator_options opt;
+  const std::uint64_t id = next_aggregator_id.fetch_add(1);
+
+  // registered counters, keys is not re-allocated (reserved at max_counters)
+  std::mutex register_mutex;
+  std::vector<std::string> keys;
+  std::unordered_map<std::string, std::size_t> index_by_key;
+  std::atomic<std::size_t> registered{0};
+
+  // slots of each thread that incremented a counter
+  std::mutex blocks_mutex;
+  std::vector<std::unique_ptr<thread_block>> blocks;
+
+  // increments collected but not flushed yet (only accessed under flush_mutex)
+  std::mutex flush_mutex;
+  std::vector<std::int64_t> pending;
+
+  std::mutex stop_mutex;
+  std::condition_variable cv;
+  bool stopped = false;
+  std::thread flusher;
+};
+
+counter_aggregator::~counter_aggregator() {
+  {
+	std::lock_guard lock(_impl->stop_mutex);
+	_impl->stopped = true;
+  }
+  _impl->cv.notify_all();
+  if (_impl->flusher.joinable()) {
+	_impl->flusher.join();
+  }
+  _impl->flush_or_report();
+}
+
+counter_aggregator::counter_aggregator(free_fdb &db, aggregator_options opt)
+	: _impl(std::make_unique<internal>(db, opt)) {
+  _impl->flusher = std::thread([this] { _impl->flush_loop(); });
+}
+
+aggregated_counter counter_aggregator::make_counter(std::string_view key) {
+  std::lock_guard lock(_impl->register_mutex);
+  if (auto it = _impl->index_by_key.find(std::string(key)); it != _impl->index_by_key.end()) {
+	return aggregated_counter(*this, it->second);
+  }
+  if (_impl->keys.size() >= _impl->opt.max_counters) {
+	throw fdb_exception(fmt::format("counter_aggregator: maximum number of counters ({}) reached", _impl->opt.max_counters));
+  }
+  const std::size_t index = _impl->keys.size();
+  _impl->keys.emplace_back(key);
+  _impl->index_by_key.emplace(key, index);
+  _impl->registered.store(_impl->keys.size(), std::memory_order_release);
+  return aggregated_counter(*this, index);
+}
+
+void counter_aggregator::flush() {
+  _impl->flush();
+}
+
+void counter_aggregator::add(std::size_t index, std::int64_t increment) {
+  _impl->local_block().slots[index].value.fetch_add(increment, std::memory_order_relaxed);
+}
+
+void aggregated_counter::add(std::int64_t increment) const {
+  _aggregator->add(_index, increment);
+}
+
+void aggregated_counter::sub(std::int64_t decrement) const {
+  _aggregator->add(_index, -decrement);
+}
+
+const std::string &aggregated_counter::key() const {
+  return _aggregator->_impl->keys[_index];
+}
+
+}// namespace ffdb
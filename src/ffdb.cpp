@@ -21,24 +21,260 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
+#include <utility>
 
 #include <internal/future.hh>
+#include <internal/mpmc_ring.hh>
+#include <internal/recorder.hh>
 
 #include <free_fdb/ffdb.hh>
+#include <free_fdb/subspace.hh>
+#include <free_fdb/watch.hh>
 
 namespace ffdb {
 
 static std::once_flag version_select_flag;
 
+//! foundationdb error code of a transaction conflict
+constexpr fdb_error_t not_committed = 1020;
+
 constexpr fdb_bool_t not_reversed() {
   return fdb_bool_t{0};
 }
 
+static const uint8_t *bytes(std::string_view data) {
+  return reinterpret_cast<const uint8_t *>(data.data());
+}
+
+static int length(std::string_view data) {
+  return static_cast<int>(data.size());
+}
+
+/**
+ * Key selector, as described in https://apple.github.io/foundationdb/api-c.html#key-selectors
+ */
+struct key_selector {
+  const uint8_t *key;
+  int key_length;
+  fdb_bool_t or_equal;
+  int offset;
+};
+
+static key_selector lower_bound_selector(std::string_view key, bool inclusive) {
+  const auto *key_name = bytes(key);
+  const int key_length = length(key);
+  if (inclusive) {
+	return key_selector{FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(key_name, key_length)};
+  }
+  return key_selector{FDB_KEYSEL_FIRST_GREATER_THAN(key_name, key_length)};
+}
+
+static key_selector upper_bound_selector(std::string_view key, bool inclusive) {
+  const auto *key_name = bytes(key);
+  const int key_length = length(key);
+  if (inclusive) {
+	return key_selector{FDB_KEYSEL_FIRST_GREATER_THAN(key_name, key_length)};
+  }
+  return key_selector{FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(key_name, key_length)};
+}
+
+/**
+ * Asynchronous operations cannot return an empty result as their blocking counterpart if the transaction is null
+ */
+static void check_transaction(FDBTransaction *trans) {
+  if (!trans) {
+	throw fdb_exception("Error: Transaction is null, the asynchronous operation cannot be made.");
+  }
+}
+
+static void set_option(FDBTransaction *trans, FDBTransactionOption option) {
+  check_fdb_code(fdb_transaction_set_option(trans, option, nullptr, 0));
+}
+
+static void set_option(FDBTransaction *trans, FDBTransactionOption option, std::int64_t value) {
+  // integer options are passed as 64 bits little endian
+  check_fdb_code(fdb_transaction_set_option(trans, option, reinterpret_cast<const uint8_t *>(&value), sizeof(value)));
+}
+
+static void set_option(FDBDatabase *db, FDBDatabaseOption option, std::int64_t value) {
+  check_fdb_code(fdb_database_set_option(db, option, reinterpret_cast<const uint8_t *>(&value), sizeof(value)));
+}
+
+static FDBFuture *get_range_future(
+	FDBTransaction *trans, const key_selector &begin, const key_selector &end,
+	int limit, int max, FDBStreamingMode mode, int iteration, fdb_bool_t snapshot, fdb_bool_t reverse) {
+  return fdb_transaction_get_range(
+	  trans,
+	  begin.key, begin.key_length, begin.or_equal, begin.offset,
+	  end.key, end.key_length, end.or_equal, end.offset,
+	  limit, max, mode, iteration, snapshot, reverse);
+}
+
+/**
+ * Start time of an operation recorded by an extractor, reset at the first call of the extractor: fdb_async::get() calls
+ * the extractor each time, the operation is recorded only once
+ */
+static metrics::recorder::clock::time_point take_start(metrics::recorder::clock::time_point &start) {
+  return std::exchange(start, metrics::recorder::clock::time_point{});
+}
+
+/**
+ * Retrieve the key/values of a range read, recording its latency (since start) and its size (if start is set)
+ * @param owner handle keeping the future alive in the view, empty if the future outlive the view
+ */
+static range_view make_range_view(FDBFuture *f, future_handle owner, metrics::recorder::clock::time_point start) {
+  metrics::recorder::record(metrics::operation::get_range, start);
+  const FDBKeyValue *key_value;
+  int out_count;
+  fdb_bool_t out_more;
+  check_fdb_code(fdb_future_get_keyvalue_array(f, &key_value, &out_count, &out_more));
+  range_view view(std::move(owner), key_value, out_count, bool(out_more));
+  if (start != metrics::recorder::clock::time_point{}) {
+	std::uint64_t size = 0;
+	for (const auto &[key, value] : view) {
+	  size += key.size() + value.size();
+	}
+	metrics::recorder::add(metrics::counter::rows_scanned, view.size());
+	metrics::recorder::add(metrics::counter::bytes_read, size);
+  }
+  return view;
+}
+
+/**
+ * @return extractor of a range read, recording its latency (from now to the retrieval of the result) and its size
+ */
+static fdb_async<range_view>::extractor recorded_range_view() {
+  return [start = metrics::recorder::start()](const future_handle &f) mutable {
+	return make_range_view(f.get(), f, take_start(start));
+  };
+}
+
+/**
+ * Value of a point read, owned by its future
+ */
+struct point_read {
+  bool present;
+  const uint8_t *value;
+  int length;
+};
+
+/**
+ * Retrieve the value of a point read, recording its latency (since start) and its size (if start is set)
+ */
+static point_read read_value(FDBFuture *f, std::size_t key_size, metrics::recorder::clock::time_point start) {
+  metrics::recorder::record(metrics::operation::get, start);
+  fdb_bool_t out_present;
+  const uint8_t *out_value;
+  int out_length;
+
+  check_fdb_code(fdb_future_get_value(f, &out_present, &out_value, &out_length));
+  if (start != metrics::recorder::clock::time_point{}) {
+	metrics::recorder::add(metrics::counter::bytes_read, key_size + (out_present ? out_length : 0));
+  }
+  return point_read{bool(out_present), out_value, out_length};
+}
+
+static std::optional<fdb_result> make_result(FDBFuture *f, std::string_view key, metrics::recorder::clock::time_point start) {
+  const auto read = read_value(f, key.size(), start);
+  if (!read.present) {
+	return std::nullopt;
+  }
+  return fdb_result{std::string(key), std::string(reinterpret_cast<const char *>(read.value), read.length)};
+}
+
+/**
+ * Read version shared between the read transactions of a free_fdb instance, refreshed in background
+ */
+class read_version_cache {
+  using clock = std::chrono::steady_clock;
+
+public:
+  read_version_cache(FDBDatabase *db, read_version_options opt) : opt(opt), grv_trans(db) {
+	refresh();
+	refresher = std::thread([this] { refresh_loop(); });
+  }
+
+  ~read_version_cache() {
+	{
+	  std::scoped_lock lock(stop_mutex);
+	  stopped = true;
+	}
+	cv.notify_all();
+	if (refresher.joinable()) {
+	  refresher.join();
+	}
+  }
+
+  /**
+   * @return the shared read version, fetched again if it is older than the max staleness (background refresh late)
+   */
+  std::int64_t get() {
+	if (is_stale()) {
+	  std::scoped_lock lock(refresh_mutex);
+	  if (is_stale()) {
+		refresh();
+	  }
+	}
+	return version.load(std::memory_order_relaxed);
+  }
+
+private:
+  [[nodiscard]] bool is_stale() const {
+	const auto fetched = clock::time_point(clock::duration(fetched_at.load(std::memory_order_acquire)));
+	return clock::now() - fetched > opt.max_staleness;
+  }
+
+  /**
+   * Fetch a new read version, has to be called with the refresh_mutex held (or before the refresher is started)
+   */
+  void refresh() {
+	// timestamp taken before the request, the version is at least as recent as the timestamp
+	const auto requested_at = clock::now();
+	grv_trans.reset();
+	const std::int64_t fetched = grv_trans.get_read_version().get();
+
+	version.store(fetched, std::memory_order_relaxed);
+	fetched_at.store(requested_at.time_since_epoch().count(), std::memory_order_release);
+  }
+
+  void refresh_loop() {
+	std::unique_lock lock(stop_mutex);
+	while (!cv.wait_for(lock, opt.refresh_interval, [this] { return stopped; })) {
+	  try {
+		std::scoped_lock refresh_lock(refresh_mutex);
+		refresh();
+	  } catch (const fdb_exception &) {
+		// the version gets stale, the readers fetch it themselves until the refresh succeed again
+	  }
+	}
+  }
+
+  read_version_options opt;
+
+  std::atomic<std::int64_t> version{0};
+  std::atomic<clock::rep> fetched_at{0};
+
+  std::mutex refresh_mutex;
+  fdb_transaction grv_trans;
+
+  std::mutex stop_mutex;
+  std::condition_variable cv;
+  bool stopped = false;
+  std::thread refresher;
+};
+
 struct free_fdb::internal {
 
-  explicit internal(const std::string &cluster_file_path) {
+  internal(const std::string &cluster_file_path, std::size_t transaction_pool_size)
+	  : pool(std::max<std::size_t>(transaction_pool_size, 1)), pool_enabled(transaction_pool_size > 0) {
 
 	std::call_once(version_select_flag, [this]() {
 	  if (auto error = fdb_select_api_version(FDB_API_VERSION); error) {
@@ -77,184 +313,530 @@ struct free_fdb::internal {
 
   FDBDatabase *db{};
 
+  //! options applied to every transaction created, the generation is incremented each time they change
+  std::shared_mutex defaults_mutex;
+  transaction_options defaults{};
+  std::uint64_t defaults_generation = 0;
+
+  //! watcher used by free_fdb::watch, created at the first call
+  std::once_flag watcher_flag;
+  std::unique_ptr<watcher> default_watcher;
+
+  //! set if the read version cache is enabled
+  std::unique_ptr<read_version_cache> read_versions;
+
+  //! transactions kept for reuse by acquire_transaction
+  mpmc_ring<fdb_transaction *> pool;
+  bool pool_enabled;
+
   std::thread t;
 };
 
 free_fdb::~free_fdb() {
+  _impl->default_watcher.reset();
+  _impl->read_versions.reset();
+  fdb_transaction *pooled = nullptr;
+  while (_impl->pool.try_pop(pooled)) {
+	delete pooled;
+  }
   if (_impl->db) {
 	fdb_database_destroy(_impl->db);
   }
 }
 
-free_fdb::free_fdb(const std::string &cluster_file_path) : _impl(std::make_unique<internal>(cluster_file_path)) {
+free_fdb::free_fdb(const std::string &cluster_file_path, std::size_t transaction_pool_size)
+	: _impl(std::make_unique<internal>(cluster_file_path, transaction_pool_size)) {
 }
 
 std::unique_ptr<fdb_transaction> free_fdb::make_transaction() {
-  return std::make_unique<fdb_transaction>(_impl->db);
+  std::shared_lock lock(_impl->defaults_mutex);
+  return std::make_unique<fdb_transaction>(_impl->db, _impl->defaults);
+}
+
+pooled_transaction free_fdb::acquire_transaction() {
+  std::shared_lock lock(_impl->defaults_mutex);
+  const transaction_recycler recycler{this, _impl->defaults_generation};
+  fdb_transaction *trans = nullptr;
+  if (_impl->pool.try_pop(trans)) {
+	return pooled_transaction(trans, recycler);
+  }
+  return pooled_transaction(new fdb_transaction(_impl->db, _impl->defaults), recycler);
+}
+
+void free_fdb::set_transaction_options(transaction_options options) {
+  std::unique_lock lock(_impl->defaults_mutex);
+  _impl->defaults = std::move(options);
+  ++_impl->defaults_generation;
+  // pooled transactions have the previous defaults, the ones in use are destroyed instead of pooled (see recycle)
+  fdb_transaction *pooled = nullptr;
+  while (_impl->pool.try_pop(pooled)) {
+	delete pooled;
+  }
+}
+
+void free_fdb::set_location_cache_size(int size) {
+  set_option(_impl->db, FDBDatabaseOption::FDB_DB_OPTION_LOCATION_CACHE_SIZE, size);
+}
+
+void free_fdb::set_max_watches(int max_watches) {
+  set_option(_impl->db, FDBDatabaseOption::FDB_DB_OPTION_MAX_WATCHES, max_watches);
+}
+
+void free_fdb::enable_read_version_cache(read_version_options options) {
+  if (options.max_staleness >= std::chrono::seconds(5)) {
+	throw fdb_exception(fmt::format(
+		"Error read version cache: max staleness of {}ms, a read version can't be used more than 5 seconds",
+		options.max_staleness.count()));
+  }
+  _impl->read_versions.reset();
+  _impl->read_versions = std::make_unique<read_version_cache>(_impl->db, options);
+}
+
+void free_fdb::disable_read_version_cache() {
+  _impl->read_versions.reset();
+}
+
+std::int64_t free_fdb::read_version() {
+  if (_impl->read_versions) {
+	return _impl->read_versions->get();
+  }
+  return acquire_transaction()->get_read_version().get();
+}
+
+pooled_transaction free_fdb::make_read_transaction() {
+  auto trans = acquire_transaction();
+  if (_impl->read_versions) {
+	trans->set_read_version(_impl->read_versions->get());
+  }
+  return trans;
+}
+
+pooled_transaction free_fdb::make_transaction_at(std::int64_t version) {
+  auto trans = acquire_transaction();
+  trans->set_read_version(version);
+  return trans;
+}
+
+watch_handle free_fdb::watch(std::string_view key, std::function<void(const std::string &)> callback) {
+  std::call_once(_impl->watcher_flag, [this]() { _impl->default_watcher = std::make_unique<watcher>(*this); });
+  return _impl->default_watcher->watch(key, std::move(callback));
+}
+
+void free_fdb::recycle(fdb_transaction *transaction, std::uint64_t generation) {
+  if (_impl->pool_enabled) {
+	try {
+	  transaction->reset();
+	  transaction->disable_snapshot();
+	} catch (const fdb_exception &) {
+	  // called from the pooled_transaction deleter, the transaction is dropped instead of pooled
+	  delete transaction;
+	  return;
+	}
+	std::shared_lock lock(_impl->defaults_mutex);
+	if (generation == _impl->defaults_generation && _impl->pool.try_push(transaction)) {
+	  return;
+	}
+  }
+  delete transaction;
+}
+
+void transaction_recycler::operator()(fdb_transaction *transaction) const {
+  if (db) {
+	db->recycle(transaction, generation);
+  } else {
+	delete transaction;
+  }
 }
 
 fdb_iterator free_fdb::make_iterator(it_options range) {
   return fdb_iterator(make_transaction(), std::move(range));
 }
 
+fdb_iterator free_fdb::make_iterator(const subspace &space, it_options opt) {
+  opt.iterate_lower_bound = space.range().begin;
+  opt.iterate_upper_bound = space.range().end;
+  return make_iterator(std::move(opt));
+}
+
 fdb_transaction::fdb_transaction(FDBDatabase *db) {
   check_fdb_code(fdb_database_create_transaction(db, &_trans));
 }
 
+fdb_transaction::fdb_transaction(FDBDatabase *db, transaction_options defaults) : fdb_transaction(db) {
+  _defaults = std::move(defaults);
+  set_options(_defaults);
+}
+
+void fdb_transaction::set_options(const transaction_options &options) {
+  if (options.timeout) {
+	set_timeout(*options.timeout);
+  }
+  if (options.retry_limit) {
+	set_retry_limit(*options.retry_limit);
+  }
+  if (options.max_retry_delay) {
+	set_max_retry_delay(*options.max_retry_delay);
+  }
+  if (options.size_limit) {
+	set_size_limit(*options.size_limit);
+  }
+  if (options.read_your_writes_disable) {
+	disable_read_your_writes();
+  }
+  if (options.read_ahead_disable) {
+	disable_read_ahead();
+  }
+  if (options.causal_read_risky) {
+	set_causal_read_risky();
+  }
+  if (options.priority != transaction_priority::normal) {
+	set_priority(options.priority);
+  }
+  if (options.lock_aware) {
+	set_lock_aware();
+  }
+}
+
+void fdb_transaction::set_timeout(std::chrono::milliseconds timeout) {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_TIMEOUT, timeout.count());
+}
+
+void fdb_transaction::set_retry_limit(int retry_limit) {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_RETRY_LIMIT, retry_limit);
+}
+
+void fdb_transaction::set_max_retry_delay(std::chrono::milliseconds delay) {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_MAX_RETRY_DELAY, delay.count());
+}
+
+void fdb_transaction::set_size_limit(std::int64_t bytes) {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_SIZE_LIMIT, bytes);
+}
+
+void fdb_transaction::disable_read_your_writes() {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_READ_YOUR_WRITES_DISABLE);
+}
+
+void fdb_transaction::disable_read_ahead() {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_READ_AHEAD_DISABLE);
+}
+
+void fdb_transaction::set_causal_read_risky() {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_CAUSAL_READ_RISKY);
+}
+
+void fdb_transaction::set_priority(transaction_priority priority) {
+  switch (priority) {
+	case transaction_priority::batch:
+	  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_PRIORITY_BATCH);
+	  break;
+	case transaction_priority::system_immediate:
+	  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_PRIORITY_SYSTEM_IMMEDIATE);
+	  break;
+	case transaction_priority::normal:
+	  // default priority of a transaction (reset the transaction to come back to it)
+	  break;
+  }
+}
+
+void fdb_transaction::set_lock_aware() {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_LOCK_AWARE);
+}
+
+void fdb_transaction::set_read_system_keys() {
+  set_option(_trans, FDBTransactionOption::FDB_TR_OPTION_READ_SYSTEM_KEYS);
+}
+
 fdb_transaction::~fdb_transaction() {
   if (_trans) {
 	fdb_transaction_destroy(_trans);
   }
 }
 
-void fdb_transaction::put(const std::string &key, const std::string &value) {
+void fdb_transaction::put(std::string_view key, std::string_view value) {
   if (_trans) {
-	const auto *key_name = reinterpret_cast<const uint8_t *>(key.c_str());
-	const auto *value_name = reinterpret_cast<const uint8_t *>(value.c_str());
-	fdb_transaction_set(_trans, key_name, key.size(), value_name, value.size());
+	fdb_transaction_set(_trans, bytes(key), length(key), bytes(value), length(value));
+	metrics::recorder::add(metrics::counter::bytes_written, key.size() + value.size());
   }
 }
 
-void fdb_transaction::del(const std::string &key) {
+void fdb_transaction::del(std::string_view key) {
   if (_trans) {
-	fdb_transaction_clear(_trans, reinterpret_cast<const uint8_t *>(key.c_str()), key.size());
+	fdb_transaction_clear(_trans, bytes(key), length(key));
+	metrics::recorder::add(metrics::counter::bytes_written, key.size());
   }
 }
 
-void fdb_transaction::del_range(const std::string &key_begin, const std::string &key_end) {
+void fdb_transaction::del_range(std::string_view key_begin, std::string_view key_end) {
   if (_trans) {
-	fdb_transaction_clear_range(
-		_trans,
-		reinterpret_cast<const uint8_t *>(key_begin.c_str()), key_begin.size(),
-		reinterpret_cast<const uint8_t *>(key_end.c_str()), key_end.size());
+	fdb_transaction_clear_range(_trans, bytes(key_begin), length(key_begin), bytes(key_end), length(key_end));
+	metrics::recorder::add(metrics::counter::bytes_written, key_begin.size() + key_end.size());
+  }
+}
+
+void fdb_transaction::del_range(const subspace &space) {
+  del_range(space.range().begin, space.range().end);
+}
+
+void fdb_transaction::atomic_op(std::string_view key, std::string_view param, FDBMutationType operation) {
+  if (_trans) {
+	fdb_transaction_atomic_op(_trans, bytes(key), length(key), bytes(param), length(param), operation);
+	metrics::recorder::add(metrics::counter::bytes_written, key.size() + param.size());
   }
 }
 
-std::optional<fdb_result> fdb_transaction::get(const std::string &key) {
+void fdb_transaction::add_conflict_range(std::string_view begin, std::string_view end, FDBConflictRangeType type) {
   if (_trans) {
-	const auto *key_name = reinterpret_cast<const uint8_t *>(key.c_str());
-	auto fut = fdb_future(fdb_transaction_get(_trans, key_name, key.size(), _snapshot_enabled));
+	check_fdb_code(fdb_transaction_add_conflict_range(_trans, bytes(begin), length(begin), bytes(end), length(end), type));
+  }
+}
 
-	return fut.get([&key](FDBFuture *f) -> std::optional<fdb_result> {
-	  fdb_bool_t out_present;
-	  const uint8_t *out_value;
-	  int out_length;
+void fdb_transaction::add_conflict_key(std::string_view key, FDBConflictRangeType type) {
+  std::string end;
+  end.reserve(key.size() + 1);
+  end.append(key);
+  end.push_back('\x00');
+  add_conflict_range(key, end, type);
+}
 
-	  check_fdb_code(fdb_future_get_value(f, &out_present, &out_value, &out_length));
-	  if (!out_present) {
-		return std::nullopt;
-	  }
-	  return fdb_result{key, std::string(reinterpret_cast<const char *>(out_value), out_length)};
-	});
+fdb_async<std::string> fdb_transaction::get_versionstamp() {
+  return fdb_async<std::string>(fdb_transaction_get_versionstamp(_trans), [](const future_handle &f) {
+	const uint8_t *out_key;
+	int out_length;
+	check_fdb_code(fdb_future_get_key(f.get(), &out_key, &out_length));
+	return std::string(reinterpret_cast<const char *>(out_key), out_length);
+  });
+}
+
+fdb_async<void> fdb_transaction::watch(std::string_view key) {
+  return fdb_async<void>(fdb_transaction_watch(_trans, bytes(key), length(key)), [](const future_handle &) {});
+}
+
+fdb_async<std::int64_t> fdb_transaction::get_read_version() {
+  return fdb_async<std::int64_t>(fdb_transaction_get_read_version(_trans), [start = metrics::recorder::start()](const future_handle &f) mutable {
+	metrics::recorder::record(metrics::operation::get_read_version, take_start(start));
+	std::int64_t version;
+	check_fdb_code(fdb_future_get_version(f.get(), &version));
+	return version;
+  });
+}
+
+void fdb_transaction::set_read_version(std::int64_t version) {
+  if (_trans) {
+	fdb_transaction_set_read_version(_trans, version);
+  }
+}
+
+std::optional<fdb_result> fdb_transaction::get(std::string_view key) {
+  if (_trans) {
+	const auto start = metrics::recorder::start();
+	fdb_future fut(fdb_transaction_get(_trans, bytes(key), length(key), _snapshot_enabled));
+	return fut.get([key, start](FDBFuture *f) { return make_result(f, key, start); });
   }
   return std::nullopt;
 }
 
-range_result fdb_transaction::get_range(const std::string &from, const std::string &to, range_options opt) {
+fdb_async<std::optional<fdb_result>> fdb_transaction::get_async(std::string_view key) {
+  check_transaction(_trans);
+  return fdb_async<std::optional<fdb_result>>(
+	  fdb_transaction_get(_trans, bytes(key), length(key), _snapshot_enabled),
+	  [start = metrics::recorder::start(), key = std::string(key)](const future_handle &f) mutable {
+		return make_result(f.get(), key, take_start(start));
+	  });
+}
+
+value_view fdb_transaction::get_view(std::string_view key) {
   if (_trans) {
+	const auto start = metrics::recorder::start();
+	fdb_future fut(fdb_transaction_get(_trans, bytes(key), length(key), _snapshot_enabled));
+	const auto read = fut.get([key_size = key.size(), start](FDBFuture *f) { return read_value(f, key_size, start); });
+	// the view takes the ownership of the future, no shared handle is allocated
+	return value_view(fut.release(), read.value, read.length, read.present);
+  }
+  return value_view{};
+}
 
-	auto appropriate_range_call = [this, &from, &to](const range_options &opt) {
-	  if (opt.lower_bound_inclusive) {
-		if (opt.upper_bound_inclusive) {
-		  // [ begin, end ]
-		  return fdb_transaction_get_range(
-			  _trans,
-			  FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(from.c_str()), from.size()),
-			  FDB_KEYSEL_FIRST_GREATER_THAN(reinterpret_cast<const uint8_t *>(to.c_str()), to.size()),
-			  opt.limit, opt.max, FDBStreamingMode::FDB_STREAMING_MODE_WANT_ALL, 0, _snapshot_enabled, not_reversed());
-		} else {
-		  // [ begin, end [
-		  return fdb_transaction_get_range(
-			  _trans,
-			  FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(from.c_str()), from.size()),
-			  FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(to.c_str()), to.size()),
-			  opt.limit, opt.max, FDBStreamingMode::FDB_STREAMING_MODE_WANT_ALL, 0, _snapshot_enabled, not_reversed());
-		}
-	  } else {
-		if (opt.upper_bound_inclusive) {
-		  // ] begin, end ]
-		  return fdb_transaction_get_range(
-			  _trans,
-			  FDB_KEYSEL_FIRST_GREATER_THAN(reinterpret_cast<const uint8_t *>(from.c_str()), from.size()),
-			  FDB_KEYSEL_FIRST_GREATER_THAN(reinterpret_cast<const uint8_t *>(to.c_str()), to.size()),
-			  opt.limit, opt.max, FDBStreamingMode::FDB_STREAMING_MODE_WANT_ALL, 0, _snapshot_enabled, not_reversed());
+fdb_async<value_view> fdb_transaction::get_view_async(std::string_view key) {
+  check_transaction(_trans);
+  return fdb_async<value_view>(
+	  fdb_transaction_get(_trans, bytes(key), length(key), _snapshot_enabled),
+	  [start = metrics::recorder::start(), key_size = key.size()](const future_handle &f) mutable {
+		const auto read = read_value(f.get(), key_size, take_start(start));
+		return value_view(f, read.value, read.length, read.present);
+	  });
+}
+
+range_result fdb_transaction::get_range(std::string_view from, std::string_view to, range_options opt) {
+  if (_trans) {
+	const auto start = metrics::recorder::start();
+	fdb_future fut(get_range_future(
+		_trans,
+		lower_bound_selector(from, opt.lower_bound_inclusive),
+		upper_bound_selector(to, opt.upper_bound_inclusive),
+		opt.limit, opt.max, FDBStreamingMode::FDB_STREAMING_MODE_WANT_ALL, 0, _snapshot_enabled || opt.snapshot, not_reversed()));
+	// the view does not own the future, which outlive the copy of the key/values
+	return fut.get([start](FDBFuture *f) { return make_range_view(f, future_handle{}, start).to_result(); });
+  }
+  return range_result{};
+}
+
+range_result fdb_transaction::get_range(const subspace &space, range_options opt) {
+  opt.lower_bound_inclusive = true;
+  opt.upper_bound_inclusive = false;
+  return get_range(space.range().begin, space.range().end, opt);
+}
+
+fdb_async<range_result> fdb_transaction::get_range_async(std::string_view from, std::string_view to, range_options opt) {
+  return get_range_view_async(from, to, opt).map([](const range_view &view) { return view.to_result(); });
+}
+
+range_view fdb_transaction::get_range_view(std::string_view from, std::string_view to, range_options opt) {
+  if (_trans) {
+	return get_range_view_async(from, to, opt).get();
+  }
+  return range_view{};
+}
+
+range_view fdb_transaction::get_range_view(const subspace &space, range_options opt) {
+  opt.lower_bound_inclusive = true;
+  opt.upper_bound_inclusive = false;
+  return get_range_view(space.range().begin, space.range().end, opt);
+}
+
+fdb_async<range_view> fdb_transaction::get_range_view_async(std::string_view from, std::string_view to, range_options opt) {
+  return fdb_async<range_view>(
+	  get_range_future(
+		  _trans,
+		  lower_bound_selector(from, opt.lower_bound_inclusive),
+		  upper_bound_selector(to, opt.upper_bound_inclusive),
+		  opt.limit, opt.max, FDBStreamingMode::FDB_STREAMING_MODE_WANT_ALL, 0, _snapshot_enabled || opt.snapshot, not_reversed()),
+	  recorded_range_view());
+}
+
+std::size_t fdb_transaction::get_range_stream(
+	std::string_view from, std::string_view to, const std::function<void(const range_view &)> &handler, stream_options opt) {
+  if (!_trans) {
+	return 0;
+  }
+  key_selector begin = lower_bound_selector(from, opt.lower_bound_inclusive);
+  key_selector end = upper_bound_selector(to, opt.upper_bound_inclusive);
+  std::string last_key;
+  std::size_t retrieved = 0;
+  int iteration = 1;
+
+  auto request = [&]() {
+	int limit = opt.limit > 0 ? opt.limit - static_cast<int>(retrieved) : 0;
+	return fdb_async<range_view>(
+		get_range_future(_trans, begin, end, limit, opt.max, opt.mode, iteration, _snapshot_enabled || opt.snapshot, opt.reverse),
+		recorded_range_view());
+  };
+
+  std::optional<fdb_async<range_view>> pending = request();
+  while (pending) {
+	range_view batch = pending->get();
+	pending.reset();
+	retrieved += batch.size();
+
+	// the next batch is requested before handling the current one, in order to overlap the network round trip
+	// with the processing of the batch
+	bool limit_reached = opt.limit > 0 && retrieved >= static_cast<std::size_t>(opt.limit);
+	if (batch.truncated() && !limit_reached) {
+	  // an empty batch can be truncated, the range is then requested again from the last key returned
+	  if (!batch.empty()) {
+		last_key = std::string(batch.back().key);
+		if (opt.reverse) {
+		  end = upper_bound_selector(last_key, false);
 		} else {
-		  // ] begin, end [
-		  return fdb_transaction_get_range(
-			  _trans,
-			  FDB_KEYSEL_FIRST_GREATER_THAN(reinterpret_cast<const uint8_t *>(from.c_str()), from.size()),
-			  FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(to.c_str()), to.size()),
-			  opt.limit, opt.max, FDBStreamingMode::FDB_STREAMING_MODE_WANT_ALL, 0, _snapshot_enabled, not_reversed());
+		  begin = lower_bound_selector(last_key, false);
 		}
 	  }
-	};
-
-	auto fut = fdb_future(appropriate_range_call(opt));
-
-	return fut.get([](FDBFuture *f) -> range_result {
-	  const FDBKeyValue *key_value;
-	  int out_count;
-	  fdb_bool_t out_more;
-	  check_fdb_code(fdb_future_get_keyvalue_array(f, &key_value, &out_count, &out_more));
-
-	  range_result result{};
-	  result.truncated = bool(out_more);
-	  result.values.reserve(out_count);
-	  for (int i = 0; i < out_count; ++i) {
-		result.values.emplace_back(fdb_result{
-			std::string(static_cast<const char *>(key_value[i].key), key_value[i].key_length),
-			std::string(static_cast<const char *>(key_value[i].value), key_value[i].value_length)});
-	  }
-	  return result;
-	});
+	  ++iteration;
+	  pending = request();
+	}
+	if (!batch.empty()) {
+	  handler(batch);
+	}
   }
-  return range_result{};
+  return retrieved;
 }
 
 void fdb_transaction::enable_snapshot() {
   _snapshot_enabled = true;
 }
 
+void fdb_transaction::disable_snapshot() {
+  _snapshot_enabled = false;
+}
+
 FDBTransaction *fdb_transaction::raw() const {
   return _trans;
 }
 
 void fdb_transaction::reset() {
   fdb_transaction_reset(_trans);
+  _user_version = 0;
+  set_options(_defaults);
 }
 
 void fdb_transaction::commit() {
+  const auto start = metrics::recorder::start();
   fdb_future(fdb_transaction_commit(_trans)).get();
+  metrics::recorder::record(metrics::operation::commit, start);
+}
+
+fdb_async<void> fdb_transaction::commit_async() {
+  check_transaction(_trans);
+  return fdb_async<void>(fdb_transaction_commit(_trans), [start = metrics::recorder::start()](const future_handle &) mutable {
+	metrics::recorder::record(metrics::operation::commit, take_start(start));
+  });
+}
+
+void fdb_transaction::on_error(fdb_error_t error) {
+  on_error_async(error).get();
+}
+
+fdb_async<void> fdb_transaction::on_error_async(fdb_error_t error) {
+  metrics::recorder::add(metrics::counter::retries, 1);
+  if (error == not_committed) {
+	metrics::recorder::add(metrics::counter::conflicts, 1);
+  }
+  return fdb_async<void>(fdb_transaction_on_error(_trans, error), [this, start = metrics::recorder::start()](const future_handle &) mutable {
+	metrics::recorder::record(metrics::operation::on_error, take_start(start));
+	// foundationdb keeps only the timeout, retry limit, max retry delay and size limit on retry, the other defaults
+	// are applied again
+	transaction_options non_persistent = _defaults;
+	non_persistent.timeout.reset();
+	non_persistent.retry_limit.reset();
+	non_persistent.max_retry_delay.reset();
+	non_persistent.size_limit.reset();
+	set_options(non_persistent);
+	_user_version = 0;
+  });
 }
 
 // Counter
 
-fdb_counter::fdb_counter(std::string key) : _key(std::move(key)) {
+fdb_counter::fdb_counter(std::string_view key) : _key(key) {
 }
 
 std::int64_t fdb_counter::value(fdb_transaction &transaction) const {
-  auto counter = transaction.get(_key);
-  if (!counter) {
-	return 0;
+  auto counter = transaction.get_view(_key);
+  std::int64_t value = 0;
+  if (counter) {
+	std::memcpy(&value, counter.value().data(), std::min(counter.value().size(), sizeof(std::int64_t)));
   }
-  return *((const std::int64_t*)(counter->value.c_str()));
+  return value;
 }
 
 void fdb_counter::add(fdb_transaction &transaction, std::int64_t increment) const {
-  fdb_transaction_atomic_op(
-	  transaction.raw(),
-	  (const uint8_t *)(_key.c_str()),
-	  _key.size(), (const uint8_t *)(&increment), sizeof(std::int64_t),
+  transaction.atomic_op(
+	  _key,
+	  std::string_view(reinterpret_cast<const char *>(&increment), sizeof(std::int64_t)),
 	  FDBMutationType::FDB_MUTATION_TYPE_ADD);
 }
 
 void fdb_counter::sub(fdb_transaction &transaction, std::int64_t decrement) const {
-  decrement *= -1;
-  fdb_transaction_atomic_op(
-	  transaction.raw(),
-	  (const uint8_t *)(_key.c_str()),
-	  _key.size(), (const uint8_t *)(&decrement), sizeof(std::int64_t),
-	  FDBMutationType::FDB_MUTATION_TYPE_ADD);
+  add(transaction, -decrement);
 }
 
 }// namespace ffdb
@@ -21,12 +21,14 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include <functional>
+#include <optional>
 
 #include <internal/future.hh>
+#include <internal/recorder.hh>
 
 #include <free_fdb/ffdb.hh>
 #include <free_fdb/iterator.hh>
+#include <free_fdb/subspace.hh>
 
 namespace {
 
@@ -46,10 +48,85 @@ struct fdb_iterator::internal {
   internal(std::shared_ptr<fdb_transaction> t, it_options opt) : trans(std::move(t)), opt(std::move(opt)) {}
 
   void reset_iterator() {
+	page.reset();
 	trans->reset();
 	validity = false;
 	current_result = {};
-	seeker = nullptr;
+  }
+
+  /**
+   * Set the range to iterate on and retrieve its first page
+   * @param begin_key lower bound of the range (inclusive)
+   * @param end_key upper bound of the range (exclusive)
+   * @param reverse_iteration true if the range has to be iterated backward
+   */
+  void start(std::string begin_key, std::string end_key, bool reverse_iteration) {
+	if (page) {
+	  reset_iterator();
+	}
+	begin = std::move(begin_key);
+	end = std::move(end_key);
+	begin_exclusive = false;
+	reverse = reverse_iteration;
+	iteration = 0;
+	retrieved = 0;
+	fetch_page();
+	validity = true;
+  }
+
+  /**
+   * Retrieve the next page of key/value pairs of the range. Each page is requested using the iterator streaming
+   * mode, fdb is then increasing the size of the pages as the iteration number grows.
+   */
+  void fetch_page() {
+	do {
+	  ++iteration;
+	  const auto start = metrics::recorder::start();
+	  page.emplace(fdb_transaction_get_range(
+		  trans->raw(),
+
+		  // FDB_KEYSEL_FIRST_GREATER_THAN if begin_exclusive, FDB_KEYSEL_FIRST_GREATER_OR_EQUAL otherwise
+		  reinterpret_cast<const uint8_t *>(begin.c_str()), begin.size(), fdb_bool_t(begin_exclusive), 1,
+		  FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(end.c_str()), end.size()),
+
+		  opt.limit > 0 ? opt.limit - retrieved : 0, opt.max,
+		  FDBStreamingMode::FDB_STREAMING_MODE_ITERATOR, iteration,
+		  opt.snapshot, reverse ? reversed() : not_reversed()));
+	  page->get([this](FDBFuture *f) {
+		check_fdb_code(fdb_future_get_keyvalue_array(f, &kv, &count, &more));
+	  });
+	  index = 0;
+	  metrics::recorder::record(metrics::operation::iterator_page, start);
+	  record_page_size();
+	} while (count == 0 && more);
+  }
+
+  void record_page_size() const {
+	if (!metrics::is_enabled()) {
+	  return;
+	}
+	std::uint64_t size = 0;
+	for (int i = 0; i < count; ++i) {
+	  size += kv[i].key_length + kv[i].value_length;
+	}
+	metrics::recorder::add(metrics::counter::rows_scanned, count);
+	metrics::recorder::add(metrics::counter::bytes_read, size);
+  }
+
+  /**
+   * Narrow the range so that the next page start right after the last key returned by the iterator
+   */
+  void continue_after_current() {
+	if (reverse) {
+	  end = current_result.key;
+	} else {
+	  begin = current_result.key;
+	  begin_exclusive = true;
+	}
+  }
+
+  [[nodiscard]] bool limit_reached() const {
+	return opt.limit > 0 && retrieved >= opt.limit;
   }
 
   std::shared_ptr<fdb_transaction> trans;
@@ -57,10 +134,23 @@ struct fdb_iterator::internal {
 
   fdb_result current_result{};
 
-  int index = 1;
   bool validity = false;
 
-  std::function<FDBFuture *(void)> seeker = nullptr;
+  // range currently iterated, narrowed each time a new page is fetched
+  std::string begin;
+  std::string end;
+  bool begin_exclusive = false;
+  bool reverse = false;
+
+  // page of key/value currently iterated, the key/value array is owned by the future
+  std::optional<fdb_future> page;
+  const FDBKeyValue *kv = nullptr;
+  int count = 0;
+  int index = 0;
+  fdb_bool_t more = 0;
+
+  int iteration = 0;
+  int retrieved = 0;
 };
 
 fdb_iterator::~fdb_iterator() = default;
@@ -70,112 +160,52 @@ fdb_iterator::fdb_iterator(std::shared_ptr<fdb_transaction> t, it_options opt)
 }
 
 void fdb_iterator::seek(std::string key) {
-  std::string end = key;
-  ++end.back();
-
-  if (_impl->seeker) {
-	_impl->reset_iterator();
-  }
-  _impl->validity = true;
-  _impl->seeker = [this, key = std::move(key), end = std::move(end)]() {
-	return fdb_transaction_get_range(
-		_impl->trans->raw(),
-
-		FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(key.c_str()), key.size()),
-		FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(end.c_str()), end.size()),
-
-		_impl->opt.limit, _impl->opt.max,
-		FDBStreamingMode::FDB_STREAMING_MODE_ITERATOR, _impl->index,
-		_impl->opt.snapshot, not_reversed());
-  };
+  std::string end = strinc(key);
+  _impl->start(std::move(key), std::move(end), false);
   next();
 }
 
 void fdb_iterator::seek_for_prev(std::string key) {
-  std::string begin = key;
-  --begin.back();
-  if (_impl->seeker) {
-	_impl->reset_iterator();
+  // keys lesser than the provided one (that is the range [lower bound, key[), within the bounds of the iterator
+  const auto &upper_bound = _impl->opt.iterate_upper_bound;
+  if (!upper_bound.empty() && upper_bound < key) {
+	key = upper_bound;
   }
-  _impl->validity = true;
-  _impl->seeker = [this, key = std::move(key), begin = std::move(begin)]() {
-	return fdb_transaction_get_range(
-		_impl->trans->raw(),
-
-		FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(begin.c_str()), begin.size()),
-		FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(reinterpret_cast<const uint8_t *>(key.c_str()), key.size()),
-
-		_impl->opt.limit, _impl->opt.max,
-		FDBStreamingMode::FDB_STREAMING_MODE_ITERATOR, _impl->index,
-		_impl->opt.snapshot, reversed());
-  };
+  _impl->start(_impl->opt.iterate_lower_bound, std::move(key), true);
   next();
 }
 
 void fdb_iterator::seek_first() {
-  if (_impl->seeker) {
-	_impl->reset_iterator();
-  }
-  _impl->validity = true;
-  _impl->seeker = [this]() {
-	return fdb_transaction_get_range(
-		_impl->trans->raw(),
-
-		FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(
-			reinterpret_cast<const uint8_t *>(_impl->opt.iterate_lower_bound.c_str()), _impl->opt.iterate_lower_bound.size()),
-		FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(
-			reinterpret_cast<const uint8_t *>(_impl->opt.iterate_upper_bound.c_str()), _impl->opt.iterate_upper_bound.size()),
-
-		_impl->opt.limit, _impl->opt.max,
-		FDBStreamingMode::FDB_STREAMING_MODE_ITERATOR, _impl->index,
-		_impl->opt.snapshot, not_reversed());
-  };
+  _impl->start(_impl->opt.iterate_lower_bound, _impl->opt.iterate_upper_bound, false);
   next();
 }
 
 void fdb_iterator::seek_last() {
-  if (_impl->seeker) {
-	_impl->reset_iterator();
-  }
-  _impl->validity = true;
-  _impl->seeker = [&]() {
-	return fdb_transaction_get_range(
-		_impl->trans->raw(),
-
-		FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(
-			reinterpret_cast<const uint8_t *>(_impl->opt.iterate_lower_bound.c_str()), _impl->opt.iterate_lower_bound.size()),
-		FDB_KEYSEL_FIRST_GREATER_OR_EQUAL(
-			reinterpret_cast<const uint8_t *>(_impl->opt.iterate_upper_bound.c_str()), _impl->opt.iterate_upper_bound.size()),
-
-		_impl->opt.limit, _impl->opt.max,
-		FDBStreamingMode::FDB_STREAMING_MODE_ITERATOR, _impl->index,
-		_impl->opt.snapshot, reversed());
-  };
+  _impl->start(_impl->opt.iterate_lower_bound, _impl->opt.iterate_upper_bound, true);
   next();
 }
 
 void fdb_iterator::next() {
-  if (is_valid()) {
-	fdb_future fut(_impl->seeker());
-	fut.get([this](FDBFuture *f) {
-	  const FDBKeyValue *kv;
-	  int count;
-	  fdb_bool_t more;
-	  check_fdb_code(fdb_future_get_keyvalue_array(f, &kv, &count, &more));
-
-	  if (count == 0 || !_impl->validity) {
-		_impl->validity = false;
-		return std::nullopt;
-	  }
-	  int index = _impl->index - 1;
-	  _impl->current_result = fdb_result{
-		  std::string(static_cast<const char *>(kv[index].key), kv[index].key_length),
-		  std::string(static_cast<const char *>(kv[index].value), kv[index].value_length)};
-	  ++_impl->index;
-	  _impl->validity = _impl->index <= count;
-	  return std::nullopt;
-	});
+  if (!is_valid()) {
+	return;
+  }
+  if (_impl->index >= _impl->count) {
+	_impl->validity = false;
+	return;
+  }
+  const FDBKeyValue &kv = _impl->kv[_impl->index];
+  _impl->current_result = fdb_result{
+	  std::string(static_cast<const char *>(kv.key), kv.key_length),
+	  std::string(static_cast<const char *>(kv.value), kv.value_length)};
+  ++_impl->index;
+  ++_impl->retrieved;
+
+  // current page fully consumed, the next one is retrieved in order to know if the iteration can continue
+  if (_impl->index == _impl->count && _impl->more && !_impl->limit_reached()) {
+	_impl->continue_after_current();
+	_impl->fetch_page();
   }
+  _impl->validity = _impl->index < _impl->count;
 }
 
 bool fdb_iterator::is_valid() const {
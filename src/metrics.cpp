@@ -0,0 +1,325 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <internal/recorder.hh>
+
+namespace ffdb::metrics {
+
+struct thread_histogram {
+  std::array<std::atomic<std::uint64_t>, histogram::bucket_count> buckets{};
+  std::atomic<std::uint64_t> count{0};
+  std::atomic<std::uint64_t> sum{0};
+  std::atomic<std::uint64_t> max{0};
+};
+
+/**
+ * Metrics recorded by a thread (~24KB)
+ */
+struct thread_block {
+  std::array<thread_histogram, operation_count> latencies{};
+  std::array<std::atomic<std::uint64_t>, counter_count> counters{};
+};
+
+}// namespace ffdb::metrics
+
+namespace {
+
+std::atomic<bool> enabled{true};
+
+/**
+ * Increment a value written by a single thread, a relaxed load and store are enough (no atomic read-modify-write),
+ * the atomic only guarantees that the readers don't see torn values
+ */
+inline void bump(std::atomic<std::uint64_t> &value, std::uint64_t increment) {
+  value.store(value.load(std::memory_order_relaxed) + increment, std::memory_order_relaxed);
+}
+
+/**
+ * Blocks of the running threads, and metrics of the terminated ones
+ */
+struct registry {
+  std::mutex mutex;
+  std::vector<ffdb::metrics::thread_block *> blocks;
+  ffdb::metrics::snapshot retired{};
+
+  static registry &instance() {
+	// never destroyed, threads can terminate after the static destruction
+	static auto *r = new registry();
+	return *r;
+  }
+};
+
+}// namespace
+
+namespace ffdb::metrics {
+
+std::string_view to_string(operation op) {
+  switch (op) {
+	case operation::get_read_version: return "get_read_version";
+	case operation::get: return "get";
+	case operation::get_range: return "get_range";
+	case operation::iterator_page: return "iterator_page";
+	case operation::commit: return "commit";
+	case operation::on_error: return "on_error";
+  }
+  return "unknown";
+}
+
+std::string_view to_string(counter c) {
+  switch (c) {
+	case counter::bytes_read: return "bytes_read";
+	case counter::bytes_written: return "bytes_written";
+	case counter::rows_scanned: return "rows_scanned";
+	case counter::conflicts: return "conflicts";
+	case counter::retries: return "retries";
+  }
+  return "unknown";
+}
+
+// Histogram
+
+void histogram::record(std::chrono::nanoseconds latency) {
+  const auto value = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(latency.count(), 0));
+  ++_buckets[bucket_of(value)];
+  ++_count;
+  _sum += value;
+  _max = std::max(_max, value);
+}
+
+void histogram::merge(const histogram &other) {
+  for (std::size_t i = 0; i < bucket_count; ++i) {
+	_buckets[i] += other._buckets[i];
+  }
+  _count += other._count;
+  _sum += other._sum;
+  _max = std::max(_max, other._max);
+}
+
+void histogram::subtract(const histogram &other) {
+  for (std::size_t i = 0; i < bucket_count; ++i) {
+	_buckets[i] -= other._buckets[i];
+  }
+  _count -= other._count;
+  _sum -= other._sum;
+  // the maximum of the difference is the upper bound of its highest bucket (capped at the maximum of this histogram)
+  std::uint64_t max = 0;
+  for (std::size_t i = bucket_count; i > 0; --i) {
+	if (_buckets[i - 1] != 0) {
+	  max = std::min(bucket_upper_bound(i - 1), _max);
+	  break;
+	}
+  }
+  _max = max;
+}
+
+std::chrono::nanoseconds histogram::percentile(double percentile) const {
+  if (_count == 0) {
+	return std::chrono::nanoseconds(0);
+  }
+  const auto rank = static_cast<std::uint64_t>(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(_count));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < bucket_count; ++i) {
+	seen += _buckets[i];
+	if (seen > rank || (seen == _count && seen > 0)) {
+	  return std::chrono::nanoseconds(std::min(bucket_upper_bound(i), _max));
+	}
+  }
+  return std::chrono::nanoseconds(_max);
+}
+
+std::chrono::nanoseconds histogram::mean() const {
+  return std::chrono::nanoseconds(_count == 0 ? 0 : _sum / _count);
+}
+
+// Snapshot
+
+snapshot snapshot::since(const snapshot &earlier) const {
+  snapshot delta = *this;
+  for (std::size_t i = 0; i < operation_count; ++i) {
+	delta.latencies[i].subtract(earlier.latencies[i]);
+  }
+  for (std::size_t i = 0; i < counter_count; ++i) {
+	delta.counters[i] -= earlier.counters[i];
+  }
+  return delta;
+}
+
+snapshot take_snapshot() {
+  return recorder::collect();
+}
+
+void set_enabled(bool enable) {
+  enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool is_enabled() {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+// Recorder
+
+void recorder::accumulate(snapshot &s, const thread_block &block) {
+  for (std::size_t op = 0; op < operation_count; ++op) {
+	const thread_histogram &source = block.latencies[op];
+	histogram &target = s.latencies[op];
+	for (std::size_t i = 0; i < histogram::bucket_count; ++i) {
+	  target._buckets[i] += source.buckets[i].load(std::memory_order_relaxed);
+	}
+	target._count += source.count.load(std::memory_order_relaxed);
+	target._sum += source.sum.load(std::memory_order_relaxed);
+	target._max = std::max(target._max, source.max.load(std::memory_order_relaxed));
+  }
+  for (std::size_t c = 0; c < counter_count; ++c) {
+	s.counters[c] += block.counters[c].load(std::memory_order_relaxed);
+  }
+}
+
+namespace {
+
+/**
+ * Block of the current thread, registered at the first record of the thread. The metrics of the block are kept by the
+ * registry when the thread terminates.
+ */
+struct local_block {
+  local_block() : block(std::make_unique<thread_block>()) {
+	registry &r = registry::instance();
+	std::scoped_lock lock(r.mutex);
+	r.blocks.push_back(block.get());
+  }
+
+  ~local_block() {
+	registry &r = registry::instance();
+	std::scoped_lock lock(r.mutex);
+	recorder::accumulate(r.retired, *block);
+	r.blocks.erase(std::find(r.blocks.begin(), r.blocks.end(), block.get()));
+  }
+
+  std::unique_ptr<thread_block> block;
+};
+
+thread_block &local() {
+  thread_local local_block local;
+  return *local.block;
+}
+
+}// namespace
+
+recorder::clock::time_point recorder::start() {
+  if (!enabled.load(std::memory_order_relaxed)) {
+	return clock::time_point{};
+  }
+  return clock::now();
+}
+
+void recorder::record(operation op, clock::time_point start) {
+  if (start == clock::time_point{}) {
+	return;
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+  const auto value = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(elapsed, 0));
+
+  thread_histogram &h = local().latencies[static_cast<std::size_t>(op)];
+  bump(h.buckets[histogram::bucket_of(value)], 1);
+  bump(h.count, 1);
+  bump(h.sum, value);
+  if (value > h.max.load(std::memory_order_relaxed)) {
+	h.max.store(value, std::memory_order_relaxed);
+  }
+}
+
+void recorder::add(counter c, std::uint64_t value) {
+  if (enabled.load(std::memory_order_relaxed)) {
+	bump(local().counters[static_cast<std::size_t>(c)], value);
+  }
+}
+
+snapshot recorder::collect() {
+  registry &r = registry::instance();
+  std::scoped_lock lock(r.mutex);
+  snapshot s = r.retired;
+  for (const thread_block *block : r.blocks) {
+	accumulate(s, *block);
+  }
+  return s;
+}
+
+// Exporter
+
+struct exporter::internal {
+
+  internal(export_handler handler, std::chrono::milliseconds interval)
+	  : handler(std::move(handler)), interval(interval), previous(take_snapshot()) {
+	thread = std::thread([this] { run(); });
+  }
+
+  ~internal() {
+	{
+	  std::scoped_lock lock(mutex);
+	  stopped = true;
+	}
+	cv.notify_all();
+	thread.join();
+	export_delta();
+  }
+
+  void run() {
+	std::unique_lock lock(mutex);
+	while (!cv.wait_for(lock, interval, [this] { return stopped; })) {
+	  export_delta();
+	}
+  }
+
+  void export_delta() {
+	snapshot current = take_snapshot();
+	try {
+	  handler(current.since(previous));
+	} catch (...) {
+	}
+	previous = std::move(current);
+  }
+
+  export_handler handler;
+  std::chrono::milliseconds interval;
+  snapshot previous;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stopped = false;
+  std::thread thread;
+};
+
+exporter::~exporter() = default;
+
+exporter::exporter(export_handler handler, std::chrono::milliseconds interval)
+	: _impl(std::make_unique<internal>(std::move(handler), interval)) {
+}
+
+}// namespace ffdb::metrics
@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <free_fdb/parallel_scan.hh>
+
+namespace {
+
+//! prefix of the system keys containing the shard boundaries of the database
+const std::string key_servers_prefix = "\xff/keyServers/";
+
+}// namespace
+
+namespace ffdb {
+
+parallel_scanner::parallel_scanner(free_fdb &db, std::string begin, std::string end, scan_options opt)
+	: _db(db), _begin(std::move(begin)), _end(std::move(end)), _opt(std::move(opt)) {
+}
+
+std::vector<std::string> parallel_scanner::split_points() const {
+  std::vector<std::string> points;
+
+  if (!_opt.split_points.empty()) {
+	std::copy_if(_opt.split_points.begin(), _opt.split_points.end(), std::back_inserter(points),
+				 [this](const std::string &point) { return point > _begin && point < _end; });
+	std::sort(points.begin(), points.end());
+	points.erase(std::unique(points.begin(), points.end()), points.end());
+	return points;
+  }
+
+  _db.run([this, &points](fdb_transaction &trans) {
+	points.clear();
+	trans.enable_snapshot();
+	trans.set_read_system_keys();
+
+	stream_options opt;
+	opt.lower_bound_inclusive = false;
+	trans.get_range_stream(key_servers_prefix + _begin, key_servers_prefix + _end, [&points](const range_view &batch) {
+	  for (const auto &kv : batch) {
+		points.emplace_back(kv.key.substr(key_servers_prefix.size()));
+	  }
+	}, opt);
+  });
+  return points;
+}
+
+std::size_t parallel_scanner::scan(const std::function<void(const range_view &)> &sink) {
+  auto points = split_points();
+
+  std::vector<std::pair<std::string, std::string>> sub_ranges;
+  sub_ranges.reserve(points.size() + 1);
+  std::string previous = _begin;
+  for (auto &point : points) {
+	sub_ranges.emplace_back(std::exchange(previous, point), point);
+  }
+  sub_ranges.emplace_back(std::move(previous), _end);
+
+  std::atomic<std::size_t> next_sub_range = 0;
+  std::atomic<std::size_t> total = 0;
+  std::atomic<bool> stop = false;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto scan_sub_range = [this, &sink, &stop](const std::string &begin, const std::string &end) {
+	std::size_t scanned = 0;
+	// unset until a key/value has been delivered (the empty key is a valid key)
+	std::optional<std::string> last_key;
+	auto trans = _db.make_transaction();
+	trans->enable_snapshot();
+
+	while (!stop) {
+	  try {
+		stream_options opt;
+		opt.mode = _opt.mode;
+		// on retry, the scan continue right after the last key already handled
+		opt.lower_bound_inclusive = !last_key;
+
+		trans->get_range_stream(last_key ? *last_key : begin, end, [&](const range_view &batch) {
+		  if (stop) {
+			throw fdb_exception("Parallel scan stopped");
+		  }
+		  sink(batch);
+		  scanned += batch.size();
+		  last_key = std::string(batch.back().key);
+		}, opt);
+		return scanned;
+	  } catch (const fdb_exception &e) {
+		if (e.code() == 0) {
+		  throw;
+		}
+		// transaction too old (the scan of a sub-range can exceed the 5 seconds limit of a transaction) or other
+		// retry-able error: the transaction is reset with backoff, and the scan continue from the last key handled
+		trans->on_error(e.code());
+	  }
+	}
+	return scanned;
+  };
+
+  auto worker = [&]() {
+	try {
+	  for (std::size_t index = next_sub_range++; index < sub_ranges.size() && !stop; index = next_sub_range++) {
+		total += scan_sub_range(sub_ranges[index].first, sub_ranges[index].second);
+	  }
+	} catch (...) {
+	  std::scoped_lock lock(error_mutex);
+	  if (!error) {
+		error = std::current_exception();
+	  }
+	  stop = true;
+	}
+  };
+
+  std::vector<std::thread> threads;
+  const auto thread_number = std::min<std::size_t>(std::max(1u, _opt.concurrency), sub_ranges.size());
+  threads.reserve(thread_number);
+  for (std::size_t i = 0; i < thread_number; ++i) {
+	threads.emplace_back(worker);
+  }
+  for (auto &t : threads) {
+	t.join();
+  }
+
+  if (error) {
+	std::rethrow_exception(error);
+  }
+  return total;
+}
+
+}// namespace ffdb
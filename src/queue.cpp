@@ -0,0 +1,101 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include <free_fdb/queue.hh>
+
+namespace ffdb {
+
+struct fdb_queue::internal {
+
+  explicit internal(subspace s) : space(std::move(s)) {}
+
+  /**
+   * Read (snapshot) up to window items at the head of the queue and dequeue max_items of them, starting at a random
+   * position in the window if random_start is set.
+   */
+  std::vector<queue_item> take(fdb_transaction &transaction, std::size_t max_items, std::size_t window, bool random_start) const {
+	// a limit of 0 means no limit for foundationdb, nothing is read
+	if (max_items == 0) {
+	  return {};
+	}
+	range_options opt;
+	opt.limit = static_cast<int>(std::min<std::size_t>(std::max(max_items, window), std::numeric_limits<int>::max()));
+	opt.snapshot = true;
+	auto head = transaction.get_range_view(space, opt);
+
+	std::size_t start = 0;
+	if (random_start && head.size() > max_items) {
+	  thread_local std::minstd_rand generator(std::random_device{}());
+	  start = generator() % (head.size() - max_items + 1);
+	}
+	const std::size_t count = std::min(max_items, head.size() - std::min(start, head.size()));
+
+	std::vector<queue_item> items;
+	items.reserve(count);
+	for (std::size_t i = start; i < start + count; ++i) {
+	  const auto &kv = head[i];
+	  // only the dequeued items conflict with the other consumers
+	  transaction.add_conflict_key(kv.key, FDBConflictRangeType::FDB_CONFLICT_RANGE_TYPE_READ);
+	  transaction.del(kv.key);
+	  items.push_back(queue_item{std::get<0>(space.unpack<tuple::versionstamp>(kv.key)), std::string(kv.value)});
+	}
+	return items;
+  }
+
+  subspace space;
+};
+
+fdb_queue::~fdb_queue() = default;
+
+fdb_queue::fdb_queue(subspace space) : _impl(std::make_unique<internal>(std::move(space))) {
+}
+
+void fdb_queue::push(fdb_transaction &transaction, std::string_view item) const {
+  auto key = tuple::pack_with_versionstamp(_impl->space.key(), tuple::versionstamp::incomplete(transaction.next_user_version()));
+  transaction.atomic_op(key, item, FDBMutationType::FDB_MUTATION_TYPE_SET_VERSIONSTAMPED_KEY);
+}
+
+std::vector<queue_item> fdb_queue::pop(fdb_transaction &transaction, std::size_t max_items) const {
+  return _impl->take(transaction, max_items, max_items, false);
+}
+
+std::vector<queue_item> fdb_queue::claim(fdb_transaction &transaction, std::size_t max_items, std::size_t window) const {
+  return _impl->take(transaction, max_items, window, true);
+}
+
+bool fdb_queue::empty(fdb_transaction &transaction) const {
+  range_options opt;
+  opt.limit = 1;
+  opt.snapshot = true;
+  return transaction.get_range_view(_impl->space, opt).empty();
+}
+
+const subspace &fdb_queue::space() const {
+  return _impl->space;
+}
+
+}// namespace ffdb
@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <free_fdb/read_cache.hh>
+
+namespace {
+
+struct entry {
+  std::string key;
+  std::optional<std::string> value;
+  std::int64_t version;
+  //! identify the entry among the successive entries of the same key, in order to not invalidate a newer entry when
+  //! the watch of an older one is triggered
+  std::uint64_t generation;
+  ffdb::fdb_async<void> watch;
+};
+
+struct shard {
+  std::mutex mutex;
+  //! most recently used entries first
+  std::list<entry> lru;
+  //! keys are views on the key of the entries (stable as long as the entry is in the list)
+  std::unordered_map<std::string_view, std::list<entry>::iterator> index;
+
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t stale = 0;
+  std::uint64_t invalidations = 0;
+  std::uint64_t evictions = 0;
+
+  /**
+   * Remove an entry from the shard, has to be called with the mutex held
+   * @return the watch of the removed entry, to be cancelled once the mutex is released
+   */
+  ffdb::fdb_async<void> remove(std::list<entry>::iterator it) {
+	ffdb::fdb_async<void> watch = it->watch;
+	index.erase(it->key);
+	lru.erase(it);
+	return watch;
+  }
+};
+
+}// namespace
+
+namespace ffdb {
+
+struct read_cache::internal : std::enable_shared_from_this<read_cache::internal> {
+
+  internal(free_fdb &db, read_cache_options opt)
+	  : db(db), opt(opt), shards(std::max<std::size_t>(opt.shards, 1)),
+		shard_capacity(std::max<std::size_t>(opt.capacity / shards.size(), 1)) {}
+
+  shard &shard_of(std::string_view key) {
+	return shards[std::hash<std::string_view>{}(key) % shards.size()];
+  }
+
+  std::optional<cached_value> lookup(std::string_view key, std::int64_t min_version) {
+	shard &s = shard_of(key);
+	std::scoped_lock lock(s.mutex);
+	auto it = s.index.find(key);
+	if (it == s.index.end()) {
+	  ++s.misses;
+	  return std::nullopt;
+	}
+	if (it->second->version < min_version) {
+	  ++s.stale;
+	  ++s.misses;
+	  return std::nullopt;
+	}
+	s.lru.splice(s.lru.begin(), s.lru, it->second);
+	++s.hits;
+	return cached_value{it->second->value, it->second->version};
+  }
+
+  /**
+   * Read the key from the database, and cache it if a watch can be set on it
+   */
+  cached_value read(std::string_view key) {
+	const bool watched = reserve_watch();
+	std::optional<fdb_async<void>> watch;
+	cached_value result;
+	try {
+	  result = db.run([key, watched, &watch](fdb_transaction &trans) {
+		value_view view = trans.get_view(key);
+		if (watched) {
+		  watch = trans.watch(key);
+		}
+		return cached_value{
+			view ? std::optional<std::string>(view.value()) : std::nullopt,
+			trans.get_read_version().get()};
+	  });
+	} catch (...) {
+	  if (watched) {
+		release_watch();
+	  }
+	  throw;
+	}
+
+	if (!watched) {
+	  uncached.fetch_add(1, std::memory_order_relaxed);
+	  return result;
+	}
+	insert(key, result, *watch);
+	return result;
+  }
+
+  /**
+   * Cache the value read, the entry is removed when its watch is triggered. The watch is registered after the entry is
+   * inserted, a watch already triggered thus removes the entry right away.
+   */
+  void insert(std::string_view key, const cached_value &read, const fdb_async<void> &watch) {
+	const std::uint64_t generation = next_generation.fetch_add(1, std::memory_order_relaxed);
+	std::vector<fdb_async<void>> released;
+
+	shard &s = shard_of(key);
+	{
+	  std::scoped_lock lock(s.mutex);
+	  auto it = s.index.find(key);
+	  // concurrent misses of the same key, the most recent read is kept
+	  if (it == s.index.end() || it->second->version <= read.version) {
+		if (it != s.index.end()) {
+		  released.emplace_back(s.remove(it->second));
+		}
+		s.lru.push_front(entry{std::string(key), read.value, read.version, generation, watch});
+		s.index.emplace(s.lru.front().key, s.lru.begin());
+	  } else {
+		released.emplace_back(watch);
+	  }
+	  while (s.lru.size() > shard_capacity) {
+		released.emplace_back(s.remove(std::prev(s.lru.end())));
+		++s.evictions;
+	  }
+	}
+	// cancellation triggers the callback of the watch, it can't be done with the mutex held
+	for (auto &released_watch : released) {
+	  released_watch.cancel();
+	}
+
+	watch.then([self = shared_from_this(), key = std::string(key), generation](const fdb_async<void> &) {
+	  self->on_watch_triggered(key, generation);
+	});
+  }
+
+  void on_watch_triggered(const std::string &key, std::uint64_t generation) {
+	release_watch();
+	shard &s = shard_of(key);
+	std::scoped_lock lock(s.mutex);
+	if (auto it = s.index.find(key); it != s.index.end() && it->second->generation == generation) {
+	  // the watch is already ready, the entry can be removed with the mutex held (no cancellation needed)
+	  s.remove(it->second);
+	  ++s.invalidations;
+	}
+  }
+
+  bool reserve_watch() {
+	if (active_watches.fetch_add(1, std::memory_order_relaxed) >= opt.max_watches) {
+	  active_watches.fetch_sub(1, std::memory_order_relaxed);
+	  return false;
+	}
+	return true;
+  }
+
+  void release_watch() {
+	active_watches.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  free_fdb &db;
+  read_cache_options opt;
+
+  std::vector<shard> shards;
+  std::size_t shard_capacity;
+
+  std::atomic<std::uint64_t> next_generation{0};
+  std::atomic<std::size_t> active_watches{0};
+  std::atomic<std::uint64_t> uncached{0};
+};
+
+read_cache::~read_cache() {
+  // the callbacks of the watches keep the internal state alive, they are all called once the watches are cancelled
+  for (auto &s : _impl->shards) {
+	std::vector<fdb_async<void>> released;
+	{
+	  std::scoped_lock lock(s.mutex);
+	  released.reserve(s.lru.size());
+	  for (auto &cached : s.lru) {
+		released.emplace_back(cached.watch);
+	  }
+	  s.index.clear();
+	  s.lru.clear();
+	}
+	for (auto &released_watch : released) {
+	  released_watch.cancel();
+	}
+  }
+}
+
+read_cache::read_cache(free_fdb &db, read_cache_options opt) : _impl(std::make_shared<internal>(db, opt)) {
+}
+
+cached_value read_cache::get(std::string_view key, std::int64_t min_version) {
+  if (auto cached = _impl->lookup(key, min_version)) {
+	return *std::move(cached);
+  }
+  return _impl->read(key);
+}
+
+void read_cache::invalidate(std::string_view key) {
+  std::optional<fdb_async<void>> watch;
+  shard &s = _impl->shard_of(key);
+  {
+	std::scoped_lock lock(s.mutex);
+	if (auto it = s.index.find(key); it != s.index.end()) {
+	  watch = s.remove(it->second);
+	}
+  }
+  if (watch) {
+	watch->cancel();
+  }
+}
+
+read_cache_stats read_cache::stats() const {
+  read_cache_stats stats;
+  for (auto &s : _impl->shards) {
+	std::scoped_lock lock(s.mutex);
+	stats.hits += s.hits;
+	stats.misses += s.misses;
+	stats.stale += s.stale;
+	stats.invalidations += s.invalidations;
+	stats.evictions += s.evictions;
+	stats.size += s.lru.size();
+  }
+  stats.uncached = _impl->uncached.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}// namespace ffdb
@@ -0,0 +1,171 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <free_fdb/sharded_counter.hh>
+
+namespace {
+
+std::int64_t decode_value(std::string_view value) {
+  std::int64_t result = 0;
+  std::memcpy(&result, value.data(), std::min(value.size(), sizeof(std::int64_t)));
+  return result;
+}
+
+std::string_view encode_value(const std::int64_t &value) {
+  return std::string_view(reinterpret_cast<const char *>(&value), sizeof(std::int64_t));
+}
+
+}// namespace
+
+namespace ffdb {
+
+struct sharded_counter::internal {
+
+  internal(std::string_view key, sharded_counter_options opt) : space(key), opt(opt) {
+	if (this->opt.shards == 0) {
+	  throw fdb_exception("sharded_counter: at least one shard is required");
+	}
+	shard_keys.reserve(this->opt.shards);
+	for (std::uint32_t i = 0; i < this->opt.shards; ++i) {
+	  shard_keys.emplace_back(space.pack(i));
+	}
+	shards_begin = shard_keys.front();
+	shards_end = space.pack(this->opt.shards);
+  }
+
+  [[nodiscard]] const std::string &select_shard() const {
+	if (opt.selection == shard_selection::per_thread) {
+	  thread_local const std::size_t thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+	  return shard_keys[thread_hash % shard_keys.size()];
+	}
+	thread_local std::minstd_rand generator(std::random_device{}());
+	return shard_keys[generator() % shard_keys.size()];
+  }
+
+  void coalescing_loop(free_fdb &db, std::chrono::milliseconds interval, sharded_counter &counter) {
+	std::unique_lock lock(mutex);
+	while (!cv.wait_for(lock, interval, [this] { return stopped; })) {
+	  lock.unlock();
+	  try {
+		db.run([&counter](fdb_transaction &trans) { counter.coalesce(trans); });
+	  } catch (const std::exception &) {
+		// retried at the next interval
+	  }
+	  lock.lock();
+	}
+  }
+
+  subspace space;
+  sharded_counter_options opt;
+
+  // shard keys are computed once at construction
+  std::vector<std::string> shard_keys;
+  std::string shards_begin;
+  std::string shards_end;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stopped = false;
+  std::thread coalescer;
+};
+
+sharded_counter::~sharded_counter() {
+  stop_coalescing();
+}
+
+sharded_counter::sharded_counter(std::string_view key, sharded_counter_options opt)
+	: _impl(std::make_unique<internal>(key, opt)) {
+}
+
+std::int64_t sharded_counter::value(fdb_transaction &transaction) const {
+  range_options opt;
+  opt.snapshot = true;
+  std::int64_t value = 0;
+  for (const auto &shard : transaction.get_range_view(_impl->shards_begin, _impl->shards_end, opt)) {
+	value += decode_value(shard.value);
+  }
+  return value;
+}
+
+void sharded_counter::add(fdb_transaction &transaction, std::int64_t increment) const {
+  transaction.atomic_op(_impl->select_shard(), encode_value(increment), FDBMutationType::FDB_MUTATION_TYPE_ADD);
+}
+
+void sharded_counter::sub(fdb_transaction &transaction, std::int64_t decrement) const {
+  add(transaction, -decrement);
+}
+
+void sharded_counter::coalesce(fdb_transaction &transaction) const {
+  range_options opt;
+  opt.snapshot = true;
+  auto shards = transaction.get_range_view(_impl->shards_begin, _impl->shards_end, opt);
+
+  const std::int64_t zero = 0;
+  std::int64_t total = 0;
+  for (const auto &shard : shards) {
+	if (shard.key == _impl->shards_begin) {
+	  continue;
+	}
+	const std::int64_t value = decode_value(shard.value);
+	total += value;
+	// the value read is removed from the shard, concurrent increments (not seen by the snapshot read) are kept
+	transaction.atomic_op(shard.key, encode_value(-value), FDBMutationType::FDB_MUTATION_TYPE_ADD);
+	transaction.atomic_op(shard.key, encode_value(zero), FDBMutationType::FDB_MUTATION_TYPE_COMPARE_AND_CLEAR);
+  }
+  if (total != 0) {
+	transaction.atomic_op(_impl->shards_begin, encode_value(total), FDBMutationType::FDB_MUTATION_TYPE_ADD);
+  }
+}
+
+void sharded_counter::start_coalescing(free_fdb &db, std::chrono::milliseconds interval) {
+  stop_coalescing();
+  _impl->stopped = false;
+  _impl->coalescer = std::thread([this, &db, interval] { _impl->coalescing_loop(db, interval, *this); });
+}
+
+void sharded_counter::stop_coalescing() {
+  if (!_impl->coalescer.joinable()) {
+	return;
+  }
+  {
+	std::lock_guard lock(_impl->mutex);
+	_impl->stopped = true;
+  }
+  _impl->cv.notify_all();
+  _impl->coalescer.join();
+}
+
+const subspace &sharded_counter::shards() const {
+  return _impl->space;
+}
+
+}// namespace ffdb
@@ -0,0 +1,340 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <free_fdb/watch.hh>
+
+namespace {
+
+struct watched_key {
+  std::uint64_t id;
+  std::string key;
+  std::function<void(const std::string &)> callback;
+
+  //! watch currently set in foundationdb
+  std::optional<ffdb::fdb_async<void>> future{};
+  //! callback to call once the watch is re-armed
+  bool notify = false;
+};
+
+}// namespace
+
+namespace ffdb {
+
+struct watcher::internal : std::enable_shared_from_this<watcher::internal> {
+
+  internal(free_fdb &db, watcher_options opt) : db(db), opt(std::move(opt)) {}
+
+  void start() {
+	thread = std::thread([this] { run(); });
+  }
+
+  void stop() {
+	std::vector<fdb_async<void>> armed;
+	{
+	  std::scoped_lock lock(mutex);
+	  stopped = true;
+	  for (auto &[id, watched] : entries) {
+		if (watched->future) {
+		  armed.emplace_back(*watched->future);
+		}
+	  }
+	  entries.clear();
+	}
+	cv.notify_all();
+	for (auto &future : armed) {
+	  future.cancel();
+	}
+	if (thread.joinable()) {
+	  thread.join();
+	}
+  }
+
+  std::uint64_t add(std::string_view key, std::function<void(const std::string &)> callback) {
+	std::uint64_t id;
+	{
+	  std::scoped_lock lock(mutex);
+	  if (entries.size() >= opt.max_watches) {
+		throw fdb_exception(
+			fmt::format("Error watch: too many watches, {} keys already watched", entries.size()), too_many_watches);
+	  }
+	  id = next_id++;
+	  entries.emplace(id, std::make_shared<watched_key>(watched_key{id, std::string(key), std::move(callback)}));
+	  to_arm.push_back(id);
+	}
+	cv.notify_one();
+	return id;
+  }
+
+  void cancel(std::uint64_t id) {
+	std::optional<fdb_async<void>> future;
+	{
+	  std::scoped_lock lock(mutex);
+	  auto it = entries.find(id);
+	  if (it == entries.end()) {
+		return;
+	  }
+	  future = std::move(it->second->future);
+	  entries.erase(it);
+	}
+	if (future) {
+	  future->cancel();
+	}
+	// wait for the callback to return if it is being called (not needed if cancelled from the callback itself)
+	if (std::this_thread::get_id() != thread.get_id()) {
+	  std::scoped_lock wait(callback_mutex);
+	}
+  }
+
+  bool is_armed(std::uint64_t id) {
+	std::scoped_lock lock(mutex);
+	auto it = entries.find(id);
+	return it != entries.end() && it->second->future.has_value();
+  }
+
+  /**
+   * Called by the network thread when a watch is triggered (or failed)
+   */
+  void on_triggered(std::uint64_t id, fdb_error_t error) {
+	{
+	  std::scoped_lock lock(mutex);
+	  triggered.emplace_back(id, error);
+	}
+	cv.notify_one();
+  }
+
+  void run() {
+	std::unique_lock lock(mutex);
+	while (!stopped) {
+	  if (backoff) {
+		backoff = false;
+		if (cv.wait_for(lock, opt.retry_delay, [this] { return stopped; })) {
+		  break;
+		}
+	  }
+	  cv.wait(lock, [this] { return stopped || !triggered.empty() || !to_arm.empty(); });
+	  if (stopped) {
+		break;
+	  }
+
+	  std::vector<std::pair<std::string, fdb_error_t>> errors;
+	  for (auto [id, error] : std::exchange(triggered, {})) {
+		auto it = entries.find(id);
+		if (it == entries.end()) {
+		  continue;
+		}
+		it->second->future.reset();
+		it->second->notify = true;
+		to_arm.push_back(id);
+		if (error != 0) {
+		  errors.emplace_back(it->second->key, error);
+		  backoff = backoff || error == too_many_watches;
+		}
+	  }
+
+	  std::vector<std::shared_ptr<watched_key>> batch;
+	  while (!backoff && !to_arm.empty() && batch.size() < opt.max_batch) {
+		if (auto it = entries.find(to_arm.front()); it != entries.end()) {
+		  batch.emplace_back(it->second);
+		}
+		to_arm.pop_front();
+	  }
+
+	  lock.unlock();
+	  report(errors);
+	  if (!batch.empty()) {
+		arm(batch);
+		notify(batch);
+	  }
+	  lock.lock();
+	}
+  }
+
+  /**
+   * Arm the watches of the batch in a single transaction, the watches are put back in the arming queue if the
+   * transaction fails
+   */
+  void arm(const std::vector<std::shared_ptr<watched_key>> &batch) {
+	auto trans = db.acquire_transaction();
+	std::vector<fdb_async<void>> futures;
+	while (true) {
+	  try {
+		futures.clear();
+		for (const auto &watched : batch) {
+		  futures.emplace_back(trans->watch(watched->key));
+		}
+		trans->commit();
+		break;
+	  } catch (const fdb_exception &e) {
+		try {
+		  trans->on_error(e.code());
+		} catch (const fdb_exception &fatal) {
+		  std::vector<std::pair<std::string, fdb_error_t>> errors;
+		  {
+			std::scoped_lock lock(mutex);
+			for (const auto &watched : batch) {
+			  to_arm.push_back(watched->id);
+			  errors.emplace_back(watched->key, fatal.code());
+			}
+			backoff = true;
+		  }
+		  report(errors);
+		  return;
+		}
+	  }
+	}
+
+	std::vector<std::pair<std::uint64_t, fdb_async<void>>> armed;
+	{
+	  std::scoped_lock lock(mutex);
+	  for (std::size_t i = 0; i < batch.size(); ++i) {
+		// not armed if cancelled in the meantime
+		if (entries.count(batch[i]->id)) {
+		  batch[i]->future = futures[i];
+		  armed.emplace_back(batch[i]->id, futures[i]);
+		}
+	  }
+	}
+	// registered without the mutex held, a watch already triggered calls its continuation right away
+	for (auto &[id, future] : armed) {
+	  future.then([self = shared_from_this(), id = id](const fdb_async<void> &triggered) {
+		fdb_error_t error = 0;
+		try {
+		  triggered.get();
+		} catch (const fdb_exception &e) {
+		  error = e.code();
+		}
+		self->on_triggered(id, error);
+	  });
+	}
+  }
+
+  /**
+   * Call the callbacks of the re-armed watches
+   */
+  void notify(const std::vector<std::shared_ptr<watched_key>> &batch) {
+	std::scoped_lock callback_lock(callback_mutex);
+	for (const auto &watched : batch) {
+	  {
+		std::scoped_lock lock(mutex);
+		if (!watched->notify || !watched->future || !entries.count(watched->id)) {
+		  continue;
+		}
+		watched->notify = false;
+	  }
+	  try {
+		watched->callback(watched->key);
+	  } catch (...) {
+	  }
+	}
+  }
+
+  void report(const std::vector<std::pair<std::string, fdb_error_t>> &errors) const {
+	if (!opt.on_error) {
+	  return;
+	}
+	for (const auto &[key, error] : errors) {
+	  try {
+		opt.on_error(key, error);
+	  } catch (...) {
+	  }
+	}
+  }
+
+  free_fdb &db;
+  watcher_options opt;
+
+  mutable std::mutex mutex;
+  std::condition_variable cv;
+  bool stopped = false;
+  bool backoff = false;
+
+  std::uint64_t next_id = 1;
+  std::unordered_map<std::uint64_t, std::shared_ptr<watched_key>> entries;
+  //! watches to arm (new ones or triggered ones)
+  std::deque<std::uint64_t> to_arm;
+  //! watches triggered by foundationdb, with their error code (0 if the key has been modified)
+  std::vector<std::pair<std::uint64_t, fdb_error_t>> triggered;
+
+  //! held while the callbacks are called
+  std::mutex callback_mutex;
+  std::thread thread;
+};
+
+watcher::~watcher() {
+  _impl->stop();
+}
+
+watcher::watcher(free_fdb &db, watcher_options opt) : _impl(std::make_shared<internal>(db, std::move(opt))) {
+  _impl->start();
+}
+
+watch_handle watcher::watch(std::string_view key, std::function<void(const std::string &)> callback) {
+  return watch_handle(_impl, _impl->add(key, std::move(callback)));
+}
+
+std::size_t watcher::size() const {
+  std::scoped_lock lock(_impl->mutex);
+  return _impl->entries.size();
+}
+
+watch_handle::~watch_handle() {
+  cancel();
+}
+
+watch_handle::watch_handle(watch_handle &&other) noexcept
+	: _watcher(std::move(other._watcher)), _id(std::exchange(other._id, 0)) {
+}
+
+watch_handle &watch_handle::operator=(watch_handle &&other) noexcept {
+  if (this != &other) {
+	cancel();
+	_watcher = std::move(other._watcher);
+	_id = std::exchange(other._id, 0);
+  }
+  return *this;
+}
+
+void watch_handle::cancel() {
+  if (auto w = _watcher.lock(); w && _id != 0) {
+	w->cancel(_id);
+  }
+  _watcher.reset();
+  _id = 0;
+}
+
+bool watch_handle::is_armed() const {
+  auto w = _watcher.lock();
+  return w && _id != 0 && w->is_armed(_id);
+}
+
+}// namespace ffdb
@@ -0,0 +1,388 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <free_fdb/write_batcher.hh>
+
+namespace {
+
+//! cap of max_batch_bytes, kept below the 10MB limit of foundationdb transactions
+constexpr std::size_t max_transaction_bytes = 9 * 1000 * 1000;
+//! estimated overhead of foundationdb for each mutation of a transaction
+constexpr std::size_t mutation_overhead = 32;
+
+enum class operation_type {
+  put,
+  del,
+  del_range,
+  atomic_op
+};
+
+struct node {
+  std::atomic<node *> next{nullptr};
+};
+
+struct operation : node {
+  operation_type type;
+  std::string key;
+  //! value for put, end key for del_range, parameter for atomic_op
+  std::string value;
+  FDBMutationType mutation{};
+  std::promise<void> promise;
+
+  /**
+   * @return estimated size of the operation in a transaction as counted by foundationdb: the mutation (with its
+   * overhead) and the write conflict range
+   */
+  [[nodiscard]] std::size_t size() const {
+	const std::size_t conflict_range = type == operation_type::del_range ? key.size() + value.size() : 2 * key.size() + 1;
+	return key.size() + value.size() + mutation_overhead + conflict_range;
+  }
+
+  void apply(ffdb::fdb_transaction &trans) const {
+	switch (type) {
+	  case operation_type::put: trans.put(key, value); break;
+	  case operation_type::del: trans.del(key); break;
+	  case operation_type::del_range: trans.del_range(key, value); break;
+	  case operation_type::atomic_op: trans.atomic_op(key, value, mutation); break;
+	}
+  }
+};
+
+/**
+ * Intrusive multi-producer single-consumer queue (Dmitry Vyukov's algorithm): push is wait-free (a single atomic
+ * exchange), pop is lock-free and only called by the batching thread.
+ */
+class mpsc_queue {
+
+public:
+  ~mpsc_queue() {
+	while (auto *op = pop()) {
+	  delete op;
+	}
+  }
+
+  void push(operation *op) {
+	push_node(op);
+  }
+
+  /**
+   * @return the oldest operation of the queue, nullptr if the queue is empty (or if a push is in progress)
+   */
+  operation *pop() {
+	node *tail = _tail;
+	node *next = tail->next.load(std::memory_order_acquire);
+	if (tail == &_stub) {
+	  if (next == nullptr) {
+		return nullptr;
+	  }
+	  _tail = next;
+	  tail = next;
+	  next = next->next.load(std::memory_order_acquire);
+	}
+	if (next != nullptr) {
+	  _tail = next;
+	  return static_cast<operation *>(tail);
+	}
+	if (tail != _head.load(std::memory_order_acquire)) {
+	  return nullptr;
+	}
+	push_node(&_stub);
+	next = tail->next.load(std::memory_order_acquire);
+	if (next != nullptr) {
+	  _tail = next;
+	  return static_cast<operation *>(tail);
+	}
+	return nullptr;
+  }
+
+private:
+  void push_node(node *n) {
+	n->next.store(nullptr, std::memory_order_relaxed);
+	node *previous = _head.exchange(n, std::memory_order_acq_rel);
+	previous->next.store(n, std::memory_order_release);
+  }
+
+  node _stub;
+  std::atomic<node *> _head{&_stub};
+  node *_tail = &_stub;
+};
+
+}// namespace
+
+namespace ffdb {
+
+struct write_batcher::internal {
+
+  struct batch {
+	std::unique_ptr<fdb_transaction> trans;
+	std::vector<std::unique_ptr<operation>> operations;
+  };
+
+  internal(free_fdb &db, batcher_options opt) : db(db), opt(opt) {}
+
+  std::future<void> submit(std::unique_ptr<operation> op) {
+	// pairs with stop: either the submission sees the batcher stopping, or stop waits for the push to be done
+	submitting.fetch_add(1, std::memory_order_seq_cst);
+	if (stopping.load(std::memory_order_seq_cst)) {
+	  submitting.fetch_sub(1, std::memory_order_release);
+	  throw fdb_exception("write_batcher: the batcher is stopped");
+	}
+	auto result = op->promise.get_future();
+	queue.push(op.release());
+	submitting.fetch_sub(1, std::memory_order_release);
+	// pairs with the fence of wait_operation: either the batching thread see the operation, or it is seen sleeping
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (sleeping.load(std::memory_order_relaxed)) {
+	  std::lock_guard lock(wake_mutex);
+	  sleeping.store(false, std::memory_order_relaxed);
+	  wake_cv.notify_one();
+	}
+	return result;
+  }
+
+  /**
+   * Wait for an operation to be pushed, or for the deadline if a batch is in progress
+   */
+  void wait_operation(const std::optional<std::chrono::steady_clock::time_point> &deadline) {
+	std::unique_lock lock(wake_mutex);
+	sleeping.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto *op = queue.pop();
+	if (op == nullptr && !stopping.load(std::memory_order_acquire)) {
+	  if (deadline) {
+		wake_cv.wait_until(lock, *deadline);
+	  } else {
+		wake_cv.wait(lock);
+	  }
+	}
+	sleeping.store(false, std::memory_order_relaxed);
+	if (op != nullptr) {
+	  pending.reset(op);
+	}
+  }
+
+  /**
+   * Batching thread loop: fill a batch until its size or time budget is reached, then commit it
+   */
+  void run() {
+	std::shared_ptr<batch> current;
+	std::size_t current_size = 0;
+	std::chrono::steady_clock::time_point deadline;
+
+	while (true) {
+	  std::unique_ptr<operation> op = pending ? std::move(pending) : std::unique_ptr<operation>(queue.pop());
+
+	  if (op) {
+		if (!current) {
+		  current = std::make_shared<batch>();
+		  current_size = 0;
+		  deadline = std::chrono::steady_clock::now() + opt.max_batch_delay;
+		}
+		current_size += op->size();
+		current->operations.emplace_back(std::move(op));
+		if (current_size < opt.max_batch_bytes && std::chrono::steady_clock::now() < deadline) {
+		  continue;
+		}
+	  } else if (current && std::chrono::steady_clock::now() < deadline && !stopping.load(std::memory_order_acquire)) {
+		wait_operation(deadline);
+		continue;
+	  } else if (!current) {
+		if (stopping.load(std::memory_order_acquire)) {
+		  return;
+		}
+		wait_operation(std::nullopt);
+		continue;
+	  }
+	  start_commit(std::move(current));
+	}
+  }
+
+  void start_commit(std::shared_ptr<batch> b) {
+	{
+	  std::unique_lock lock(in_flight_mutex);
+	  in_flight_cv.wait(lock, [this] { return in_flight < opt.max_in_flight; });
+	  ++in_flight;
+	}
+	try {
+	  b->trans = db.make_transaction();
+	} catch (...) {
+	  fail(b, std::current_exception());
+	  return;
+	}
+	commit(b);
+  }
+
+  void commit(const std::shared_ptr<batch> &b) {
+	try {
+	  for (const auto &op : b->operations) {
+		op->apply(*b->trans);
+	  }
+	  b->trans->commit_async().then([this, b](const fdb_async<void> &result) {
+		try {
+		  result.get();
+		} catch (const fdb_exception &e) {
+		  retry(b, e);
+		  return;
+		}
+		for (auto &op : b->operations) {
+		  op->promise.set_value();
+		}
+		done();
+	  });
+	} catch (...) {
+	  fail(b, std::current_exception());
+	}
+  }
+
+  void retry(const std::shared_ptr<batch> &b, const fdb_exception &error) {
+	if (error.code() == 0) {
+	  fail(b, std::make_exception_ptr(error));
+	  return;
+	}
+	// the transaction is reset by on_error, operations are applied again on the retry
+	try {
+	  b->trans->on_error_async(error.code()).then([this, b](const fdb_async<void> &result) {
+		try {
+		  result.get();
+		} catch (...) {
+		  fail(b, std::current_exception());
+		  return;
+		}
+		commit(b);
+	  });
+	} catch (...) {
+	  fail(b, std::current_exception());
+	}
+  }
+
+  void fail(const std::shared_ptr<batch> &b, const std::exception_ptr &error) {
+	for (auto &op : b->operations) {
+	  op->promise.set_exception(error);
+	}
+	done();
+  }
+
+  void done() {
+	std::lock_guard lock(in_flight_mutex);
+	--in_flight;
+	in_flight_cv.notify_all();
+  }
+
+  void stop() {
+	{
+	  std::lock_guard lock(wake_mutex);
+	  stopping.store(true, std::memory_order_seq_cst);
+	  wake_cv.notify_one();
+	}
+	if (batching_thread.joinable()) {
+	  batching_thread.join();
+	}
+	// operations pushed while the batching thread was exiting are failed instead of being dropped with the queue
+	while (submitting.load(std::memory_order_acquire) != 0) {
+	  std::this_thread::yield();
+	}
+	while (auto *op = queue.pop()) {
+	  op->promise.set_exception(std::make_exception_ptr(fdb_exception("write_batcher: the batcher is stopped")));
+	  delete op;
+	}
+	std::unique_lock lock(in_flight_mutex);
+	in_flight_cv.wait(lock, [this] { return in_flight == 0; });
+  }
+
+  free_fdb &db;
+  batcher_options opt;
+
+  mpsc_queue queue;
+  //! operation popped while waiting, handled by the next iteration of the batching loop
+  std::unique_ptr<operation> pending;
+
+  std::atomic<bool> stopping{false};
+  //! number of submit calls between their stopping check and the end of their push
+  std::atomic<unsigned> submitting{0};
+  std::atomic<bool> sleeping{false};
+  std::mutex wake_mutex;
+  std::condition_variable wake_cv;
+
+  std::mutex in_flight_mutex;
+  std::condition_variable in_flight_cv;
+  unsigned in_flight = 0;
+
+  std::thread batching_thread;
+};
+
+write_batcher::~write_batcher() {
+  _impl->stop();
+}
+
+write_batcher::write_batcher(free_fdb &db, batcher_options opt) : _impl(std::make_unique<internal>(db, opt)) {
+  if (opt.max_in_flight == 0) {
+	throw fdb_exception("write_batcher: max_in_flight has to be at least 1");
+  }
+  if (opt.max_batch_bytes == 0 || opt.max_batch_bytes > max_transaction_bytes) {
+	throw fdb_exception(fmt::format(
+		"write_batcher: max_batch_bytes has to be between 1 and {} (transactions are limited to 10MB)", max_transaction_bytes));
+  }
+  _impl->batching_thread = std::thread([this] { _impl->run(); });
+}
+
+std::future<void> write_batcher::put(std::string_view key, std::string_view value) {
+  auto op = std::make_unique<operation>();
+  op->type = operation_type::put;
+  op->key = key;
+  op->value = value;
+  return _impl->submit(std::move(op));
+}
+
+std::future<void> write_batcher::del(std::string_view key) {
+  auto op = std::make_unique<operation>();
+  op->type = operation_type::del;
+  op->key = key;
+  return _impl->submit(std::move(op));
+}
+
+std::future<void> write_batcher::del_range(std::string_view begin, std::string_view end) {
+  auto op = std::make_unique<operation>();
+  op->type = operation_type::del_range;
+  op->key = begin;
+  op->value = end;
+  return _impl->submit(std::move(op));
+}
+
+std::future<void> write_batcher::atomic_op(std::string_view key, std::string_view param, FDBMutationType operation) {
+  auto op = std::make_unique<::operation>();
+  op->type = operation_type::atomic_op;
+  op->key = key;
+  op->value = param;
+  op->mutation = operation;
+  return _impl->submit(std::move(op));
+}
+
+}// namespace ffdb
@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch2/catch.hpp>
+
+#include <condition_variable>
+
+#include "db_setup_test.hh"
+
+static std::once_flag once;
+
+TEST_CASE("async_testcase") {
+
+  // full clear db for test
+  std::call_once(once, [trans = testing::ffdb.make_transaction()]() {
+	trans->del_range("", "\xFF");
+	trans->commit();
+  });
+
+  auto init_trans = testing::ffdb.make_transaction();
+  init_trans->put("async_key_1", "async_value_1");
+  init_trans->put("async_key_2", "async_value_2");
+  init_trans->put("async_key_3", "async_value_3");
+  init_trans->commit();
+
+  SECTION("multiple get in flight") {
+	auto trans = testing::ffdb.make_transaction();
+
+	auto f1 = trans->get_async("async_key_1");
+	auto f2 = trans->get_async("async_key_2");
+	auto f3 = trans->get_async("async_key_3");
+	auto f_not_found = trans->get_async("NOT_FOUND");
+
+	auto kv1 = f1.get();
+	auto kv2 = f2.get();
+	auto kv3 = f3.get();
+
+	REQUIRE(kv1);
+	REQUIRE(kv2);
+	REQUIRE(kv3);
+	CHECK(kv1->value == "async_value_1");
+	CHECK(kv2->value == "async_value_2");
+	CHECK(kv3->value == "async_value_3");
+	CHECK_FALSE(f_not_found.get().has_value());
+	CHECK(f1.is_ready());
+
+  }// End section : multiple get in flight
+
+  SECTION("continuation") {
+	auto trans = testing::ffdb.make_transaction();
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool done = false;
+	std::optional<ffdb::fdb_result> result;
+
+	trans->get_async("async_key_2").then([&](const auto &fut) {
+	  auto kv = fut.get();
+	  std::scoped_lock lock(mutex);
+	  result = std::move(kv);
+	  done = true;
+	  cv.notify_one();
+	});
+
+	std::unique_lock lock(mutex);
+	cv.wait(lock, [&done] { return done; });
+	REQUIRE(result);
+	CHECK(result->key == "async_key_2");
+	CHECK(result->value == "async_value_2");
+
+  }// End section : continuation
+
+  SECTION("get_range_async") {
+	auto trans = testing::ffdb.make_transaction();
+	auto range = trans->get_range_async("async_key_1", "async_key_3").get();
+
+	REQUIRE(2 == range.values.size());
+	CHECK(range.values[0].key == "async_key_1");
+	CHECK(range.values[1].key == "async_key_2");
+	CHECK_FALSE(range.truncated);
+
+  }// End section : get_range_async
+
+  SECTION("commit_async") {
+	auto trans = testing::ffdb.make_transaction();
+	trans->put("async_key_4", "async_value_4");
+
+	auto commit = trans->commit_async();
+	commit.get();
+	CHECK(commit.is_ready());
+
+	auto check_trans = testing::ffdb.make_transaction();
+	auto kv = check_trans->get("async_key_4");
+	REQUIRE(kv);
+	CHECK(kv->value == "async_value_4");
+
+  }// End section : commit_async
+
+}// End TestCase : async_testcase
@@ -0,0 +1,163 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+#include "../include/free_fdb/bulk_loader.hh"
+#include "db_setup_test.hh"
+
+namespace {
+
+std::string write_input(const std::string &name, const std::string &content) {
+  std::string path = fmt::format("/tmp/ffdb_{}", name);
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(content.data(), static_cast<std::streamsize>(content.size()));
+  return path;
+}
+
+}// namespace
+
+TEST_CASE("bulk_loader_testcase", "[db_test]") {
+
+  constexpr int number_record = 5000;
+
+  SECTION("length-prefixed input with checkpoint") {
+	std::string content;
+	for (int i = 0; i < number_record; ++i) {
+	  ffdb::bulk_loader::encode_record(content, fmt::format("BL_{:05}", i), std::string(100, 'v'));
+	}
+	auto path = write_input("bulk_loader_prefixed", content);
+
+	ffdb::load_options opt;
+	opt.concurrency = 4;
+	opt.partitions = 8;
+	opt.max_batch_bytes = 64 * 1024;
+	opt.checkpoint = ffdb::subspace("BLCHECKPOINT/");
+
+	ffdb::bulk_loader loader(testing::ffdb, path, opt);
+	CHECK(loader.partitions() == 8);
+
+	auto stats = loader.load();
+	CHECK(stats.records == number_record);
+	CHECK(stats.bytes == number_record * (8 + 100));
+	CHECK(stats.transactions >= number_record * 108 / (64 * 1024));
+	CHECK(stats.resumed_partitions == 0);
+
+	auto trans = testing::ffdb.make_transaction();
+	auto result = trans->get_range_view("BL_", "BL_\xff");
+	CHECK(result.size() == number_record);
+	CHECK(result[42].key == "BL_00042");
+	CHECK(result[42].value == std::string(100, 'v'));
+
+	// everything is checkpointed, nothing is loaded again
+	ffdb::bulk_loader resumed(testing::ffdb, path, opt);
+	auto resumed_stats = resumed.load();
+	CHECK(resumed_stats.records == 0);
+	CHECK(resumed_stats.resumed_partitions == 8);
+
+	// different partitioning is refused
+	opt.partitions = 3;
+	ffdb::bulk_loader other(testing::ffdb, path, opt);
+	CHECK_THROWS_AS(other.load(), ffdb::fdb_exception);
+
+	resumed.clear_checkpoint();
+	auto check_trans = testing::ffdb.make_transaction();
+	CHECK(check_trans->get_range(*opt.checkpoint).values.empty());
+
+	std::remove(path.c_str());
+
+  }// End section : length-prefixed input with checkpoint
+
+  SECTION("fixed size input") {
+	std::string content;
+	for (int i = 0; i < number_record; ++i) {
+	  content += fmt::format("BL_{:05}", i);
+	  content += fmt::format("{:08}", i);
+	}
+	auto path = write_input("bulk_loader_fixed", content);
+
+	ffdb::load_options opt;
+	opt.fixed_key_size = 8;
+	opt.fixed_value_size = 8;
+
+	ffdb::bulk_loader loader(testing::ffdb, path, opt);
+	auto stats = loader.load();
+	CHECK(stats.records == number_record);
+
+	auto trans = testing::ffdb.make_transaction();
+	auto kv = trans->get("BL_04999");
+	REQUIRE(kv);
+	CHECK(kv->value == "00004999");
+
+	std::remove(path.c_str());
+
+  }// End section : fixed size input
+
+  SECTION("fixed size input with empty values") {
+	std::string content;
+	for (int i = 0; i < 100; ++i) {
+	  content += fmt::format("BE_{:05}", i);
+	}
+	auto path = write_input("bulk_loader_fixed_empty", content);
+
+	ffdb::load_options opt;
+	opt.fixed_key_size = 8;
+	ffdb::bulk_loader loader(testing::ffdb, path, opt);
+	CHECK(loader.load().records == 100);
+
+	auto trans = testing::ffdb.make_transaction();
+	auto kv = trans->get("BE_00099");
+	REQUIRE(kv);
+	CHECK(kv->value.empty());
+	trans->del_range("BE_", "BE`");
+	trans->commit();
+
+	ffdb::load_options value_only;
+	value_only.fixed_value_size = 8;
+	CHECK_THROWS_AS(ffdb::bulk_loader(testing::ffdb, path, value_only), ffdb::fdb_exception);
+
+	std::remove(path.c_str());
+
+  }// End section : fixed size input with empty values
+
+  SECTION("malformed input") {
+	std::string content;
+	ffdb::bulk_loader::encode_record(content, "BL_key", "value");
+	content.pop_back();
+	auto path = write_input("bulk_loader_malformed", content);
+
+	CHECK_THROWS_AS(ffdb::bulk_loader(testing::ffdb, path), ffdb::fdb_exception);
+	CHECK_THROWS_AS(ffdb::bulk_loader(testing::ffdb, "/tmp/ffdb_not_existing_file"), ffdb::fdb_exception);
+
+	std::remove(path.c_str());
+
+  }// End section : malformed input
+
+  auto clear_trans = testing::ffdb.make_transaction();
+  clear_trans->del_range("BL_", "BL`");
+  clear_trans->commit();
+
+}// End TestCase : bulk_loader_testcase
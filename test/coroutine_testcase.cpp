@@ -0,0 +1,145 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch2/catch.hpp>
+
+#include <deque>
+
+#include "../include/free_fdb/coroutine.hh"
+#include "db_setup_test.hh"
+
+static std::once_flag once;
+
+namespace {
+
+/**
+ * Minimal executor running the posted work on a dedicated thread
+ */
+class single_thread_executor {
+public:
+  single_thread_executor() : _thread([this]() { run(); }) {}
+
+  ~single_thread_executor() {
+	{
+	  std::scoped_lock lock(_mutex);
+	  _stop = true;
+	}
+	_cv.notify_one();
+	_thread.join();
+  }
+
+  void post(std::function<void()> work) {
+	{
+	  std::scoped_lock lock(_mutex);
+	  _queue.emplace_back(std::move(work));
+	}
+	_cv.notify_one();
+  }
+
+  [[nodiscard]] std::thread::id id() const { return _thread.get_id(); }
+
+private:
+  void run() {
+	while (true) {
+	  std::unique_lock lock(_mutex);
+	  _cv.wait(lock, [this] { return _stop || !_queue.empty(); });
+	  if (_queue.empty()) {
+		return;
+	  }
+	  auto work = std::move(_queue.front());
+	  _queue.pop_front();
+	  lock.unlock();
+	  work();
+	}
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::deque<std::function<void()>> _queue;
+  bool _stop = false;
+  std::thread _thread;
+};
+
+ffdb::task<std::string> chained_reads(ffdb::fdb_transaction &trans) {
+  auto first = co_await trans.get_async("coro_key_1");
+  auto second = co_await trans.get_async(first->value);
+  co_return second->value;
+}
+
+ffdb::task<> write_and_commit(ffdb::fdb_transaction &trans) {
+  trans.put("coro_key_3", "coro_value_3");
+  co_await trans.commit_async();
+}
+
+ffdb::task<std::thread::id> resumed_on(ffdb::fdb_transaction &trans, single_thread_executor &executor) {
+  co_await ffdb::resume_on(executor, trans.get_async("coro_key_1"));
+  co_return std::this_thread::get_id();
+}
+
+ffdb::task<> failing(ffdb::fdb_transaction &trans) {
+  co_await trans.get_async("coro_key_1");
+  throw std::runtime_error("failure");
+}
+
+}// namespace
+
+TEST_CASE("coroutine_testcase") {
+
+  // full clear db for test
+  std::call_once(once, [trans = testing::ffdb.make_transaction()]() {
+	trans->del_range("", "\xFF");
+	trans->commit();
+  });
+
+  auto init_trans = testing::ffdb.make_transaction();
+  init_trans->put("coro_key_1", "coro_key_2");
+  init_trans->put("coro_key_2", "coro_value_2");
+  init_trans->commit();
+
+  SECTION("chained reads") {
+	auto trans = testing::ffdb.make_transaction();
+	CHECK(ffdb::sync_wait(chained_reads(*trans)) == "coro_value_2");
+  }// End section : chained reads
+
+  SECTION("commit") {
+	auto trans = testing::ffdb.make_transaction();
+	ffdb::sync_wait(write_and_commit(*trans));
+
+	auto check_trans = testing::ffdb.make_transaction();
+	auto kv = check_trans->get("coro_key_3");
+	REQUIRE(kv);
+	CHECK(kv->value == "coro_value_3");
+  }// End section : commit
+
+  SECTION("resume on executor") {
+	single_thread_executor executor;
+	auto trans = testing::ffdb.make_transaction();
+	CHECK(ffdb::sync_wait(resumed_on(*trans, executor)) == executor.id());
+  }// End section : resume on executor
+
+  SECTION("exception propagation") {
+	auto trans = testing::ffdb.make_transaction();
+	CHECK_THROWS_AS(ffdb::sync_wait(failing(*trans)), std::runtime_error);
+  }// End section : exception propagation
+
+}// End TestCase : coroutine_testcase
@@ -23,6 +23,11 @@
 
 #include <catch2/catch.hpp>
 
+#include <atomic>
+
+#include "../include/free_fdb/counter_aggregator.hh"
+#include "../include/free_fdb/sharded_counter.hh"
+
 #include "db_setup_test.hh"
 
 static std::once_flag once;
@@ -105,4 +110,164 @@ TEST_CASE("counter_testcase") {
 
   }// End section : parallel
 
-}// End TestCase : counter_testcase
\ No newline at end of file
+}// End TestCase : counter_testcase
+
+TEST_CASE("sharded_counter_testcase") {
+
+  SECTION("add and sub on shards") {
+	ffdb::sharded_counter counter("a_sharded_counter", ffdb::sharded_counter_options{4, ffdb::shard_selection::random});
+
+	auto trans = testing::ffdb.make_transaction();
+	CHECK(counter.value(*trans) == 0);
+
+	for (int i = 0; i < 100; ++i) {
+	  counter.add(*trans);
+	}
+	counter.sub(*trans, 10);
+	trans->commit();
+
+	auto check_trans = testing::ffdb.make_transaction();
+	CHECK(counter.value(*check_trans) == 90);
+	// keys of the counter are only in its own subspace, within the configured number of shards
+	auto shards = check_trans->get_range(counter.shards());
+	CHECK(shards.values.size() <= 4);
+
+	SECTION("coalesce") {
+	  auto coalesce_trans = testing::ffdb.make_transaction();
+	  counter.coalesce(*coalesce_trans);
+	  coalesce_trans->commit();
+
+	  auto after_trans = testing::ffdb.make_transaction();
+	  CHECK(counter.value(*after_trans) == 90);
+	  auto coalesced = after_trans->get_range(counter.shards());
+	  REQUIRE(coalesced.values.size() == 1);
+	  CHECK(coalesced.values[0].key == counter.shards().pack(0));
+
+	}// End section : coalesce
+
+	auto clear_trans = testing::ffdb.make_transaction();
+	clear_trans->del_range(counter.shards());
+	clear_trans->commit();
+
+  }// End section : add and sub on shards
+
+  SECTION("parallel aggressive with background coalescing") {
+	ffdb::sharded_counter counter("a_parallel_sharded_counter");
+	counter.start_coalescing(testing::ffdb, std::chrono::milliseconds(5));
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+	  threads.emplace_back([&counter]() {
+		for (int i = 0; i < 250; ++i) {
+		  testing::ffdb.run([&counter](ffdb::fdb_transaction &trans) { counter.add(trans); });
+		}
+	  });
+	}
+	for (auto &t : threads) {
+	  t.join();
+	}
+	counter.stop_coalescing();
+
+	auto trans = testing::ffdb.make_transaction();
+	CHECK(counter.value(*trans) == 1000);
+
+	trans->del_range(counter.shards());
+	trans->commit();
+
+  }// End section : parallel aggressive with background coalescing
+
+}// End TestCase : sharded_counter_testcase
+
+TEST_CASE("counter_aggregator_testcase") {
+
+  SECTION("increments are flushed in batch") {
+	ffdb::aggregator_options opt;
+	opt.flush_interval = std::chrono::hours(1);// only explicit flush
+	ffdb::counter_aggregator aggregator(testing::ffdb, opt);
+
+	auto hits = aggregator.make_counter("aggregated_hits");
+	auto misses = aggregator.make_counter("aggregated_misses");
+	CHECK(aggregator.make_counter("aggregated_hits").key() == hits.key());
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+	  threads.emplace_back([&]() {
+		for (int i = 0; i < 10000; ++i) {
+		  hits.add();
+		  if (i % 2 == 0) {
+			misses.add(2);
+		  }
+		}
+		misses.sub(5);
+	  });
+	}
+	for (auto &t : threads) {
+	  t.join();
+	}
+
+	auto before_trans = testing::ffdb.make_transaction();
+	CHECK_FALSE(before_trans->get("aggregated_hits"));
+
+	aggregator.flush();
+
+	auto trans = testing::ffdb.make_transaction();
+	CHECK(ffdb::fdb_counter("aggregated_hits").value(*trans) == 40000);
+	CHECK(ffdb::fdb_counter("aggregated_misses").value(*trans) == 39980);
+
+	trans->del("aggregated_hits");
+	trans->del("aggregated_misses");
+	trans->commit();
+
+  }// End section : increments are flushed in batch
+
+  SECTION("background flush") {
+	ffdb::aggregator_options opt;
+	opt.flush_interval = std::chrono::milliseconds(10);
+	ffdb::counter_aggregator aggregator(testing::ffdb, opt);
+	auto counter = aggregator.make_counter("aggregated_background");
+
+	counter.add(42);
+
+	std::int64_t value = 0;
+	for (int retry = 0; retry < 100 && value != 42; ++retry) {
+	  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	  auto trans = testing::ffdb.make_transaction();
+	  value = ffdb::fdb_counter("aggregated_background").value(*trans);
+	}
+	CHECK(value == 42);
+
+	auto trans = testing::ffdb.make_transaction();
+	trans->del("aggregated_background");
+	trans->commit();
+
+  }// End section : background flush
+
+  SECTION("maximum number of counters") {
+	ffdb::aggregator_options opt;
+	opt.max_counters = 1;
+	ffdb::counter_aggregator aggregator(testing::ffdb, opt);
+
+	aggregator.make_counter("aggregated_first");
+	CHECK_THROWS_AS(aggregator.make_counter("aggregated_second"), ffdb::fdb_exception);
+
+  }// End section : maximum number of counters
+
+  SECTION("flush errors are reported") {
+	std::atomic<int> errors = 0;
+	ffdb::aggregator_options opt;
+	opt.flush_interval = std::chrono::milliseconds(10);
+	opt.on_flush_error = [&errors](const ffdb::fdb_exception &) { ++errors; };
+	ffdb::counter_aggregator aggregator(testing::ffdb, opt);
+	// system keys can't be written without the access_system_keys option: every flush fails
+	auto counter = aggregator.make_counter("\xff/aggregated_error");
+
+	counter.add();
+	CHECK_THROWS_AS(aggregator.flush(), ffdb::fdb_exception);
+	for (int retry = 0; retry < 100 && errors == 0; ++retry) {
+	  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	CHECK(errors > 0);
+
+  }// End section : flush errors are reported
+
+}// End TestCase : counter_aggregator_testcase
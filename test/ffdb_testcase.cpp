@@ -21,6 +21,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <atomic>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
 #include <fmt/format.h>
@@ -209,4 +212,526 @@ TEST_CASE("ffdb_testcase_put_get_delete") {
 
   }// End section : list test
 
-}// End TestCase : ffdb_testcase_put_get_delete
\ No newline at end of file
+}// End TestCase : ffdb_testcase_put_get_delete
+
+TEST_CASE("ffdb_testcase_run") {
+
+  SECTION("run without conflict") {
+	ffdb::run_stats stats;
+	auto value = testing::ffdb.run([](ffdb::fdb_transaction &trans) {
+	  trans.put("run_key_1", "run_value_1");
+	  return trans.get("run_key_1");
+	}, &stats);
+
+	REQUIRE(value);
+	CHECK(value->value == "run_value_1");
+	CHECK(0 == stats.retries);
+	CHECK(0 == stats.last_error);
+
+	auto trans = testing::ffdb.make_transaction();
+	CHECK(trans->get("run_key_1"));
+
+  }// End section : run without conflict
+
+  SECTION("run retried on conflict") {
+	ffdb::run_stats stats;
+	int attempt = 0;
+
+	testing::ffdb.run([&attempt](ffdb::fdb_transaction &trans) {
+	  ++attempt;
+	  auto current = trans.get("run_key_2");
+	  if (attempt == 1) {
+		// concurrent write on a key read by the transaction, make the commit fail with a conflict
+		auto concurrent = testing::ffdb.make_transaction();
+		concurrent->put("run_key_2", "concurrent");
+		concurrent->commit();
+	  }
+	  trans.put("run_key_2", current ? current->value + "_updated" : "created");
+	}, &stats);
+
+	CHECK(2 == attempt);
+	CHECK(1 == stats.retries);
+	CHECK(1020 == stats.last_error);// not_committed
+
+	auto trans = testing::ffdb.make_transaction();
+	auto kv = trans->get("run_key_2");
+	REQUIRE(kv);
+	CHECK(kv->value == "concurrent_updated");
+
+  }// End section : run retried on conflict
+
+  SECTION("non foundationdb exception are not retried") {
+	int attempt = 0;
+	auto failing_handler = [&attempt](ffdb::fdb_transaction &) {
+	  ++attempt;
+	  throw std::runtime_error("error");
+	};
+	CHECK_THROWS_AS(testing::ffdb.run(failing_handler), std::runtime_error);
+	CHECK(1 == attempt);
+
+  }// End section : non foundationdb exception are not retried
+
+}// End TestCase : ffdb_testcase_run
+
+
+TEST_CASE("ffdb_testcase_views") {
+
+  auto init_trans = testing::ffdb.make_transaction();
+  init_trans->put("view_key_1", "view_value_1");
+  init_trans->put("view_key_2", "view_value_2");
+  init_trans->put("view_key_3", "view_value_3");
+  init_trans->commit();
+
+  SECTION("range view") {
+	ffdb::range_view view;
+	{
+	  auto trans = testing::ffdb.make_transaction();
+	  view = trans->get_range_view("view_key_", "view_key_9");
+	}
+
+	REQUIRE(3 == view.size());
+	CHECK_FALSE(view.truncated());
+	CHECK(view[0].key == "view_key_1");
+	CHECK(view[0].value == "view_value_1");
+	CHECK(view.back().key == "view_key_3");
+
+	int counter = 1;
+	for (auto [key, value] : view) {
+	  CHECK(key == fmt::format("view_key_{}", counter));
+	  CHECK(value == fmt::format("view_value_{}", counter));
+	  ++counter;
+	}
+
+	auto copy = view.to_result();
+	REQUIRE(3 == copy.values.size());
+	CHECK(copy.values[2].value == "view_value_3");
+
+	SECTION("with limit") {
+	  auto trans = testing::ffdb.make_transaction();
+	  auto limited = trans->get_range_view("view_key_", "view_key_9", ffdb::range_options{2});
+	  CHECK(2 == limited.size());
+	  CHECK(limited.truncated());
+	}// End section : with limit
+
+  }// End section : range view
+
+  SECTION("value view") {
+	auto trans = testing::ffdb.make_transaction();
+
+	auto found = trans->get_view("view_key_2");
+	auto not_found = trans->get_view("view_key_not_found");
+
+	REQUIRE(found);
+	CHECK(found.has_value());
+	CHECK(found.value() == "view_value_2");
+	CHECK(*found == "view_value_2");
+
+	CHECK_FALSE(not_found);
+	CHECK(not_found.value().empty());
+
+	SECTION("async") {
+	  auto f1 = trans->get_view_async("view_key_1");
+	  auto f3 = trans->get_view_async("view_key_3");
+	  CHECK(f1.get().value() == "view_value_1");
+	  CHECK(f3.get().value() == "view_value_3");
+	}// End section : async
+
+  }// End section : value view
+
+  SECTION("multi get") {
+	auto trans = testing::ffdb.make_transaction();
+
+	std::vector<std::string> keys = {"view_key_3", "view_key_not_found", "view_key_1"};
+	auto values = trans->multi_get(keys);
+
+	REQUIRE(3 == values.size());
+	CHECK(values[0].value() == "view_value_3");
+	CHECK_FALSE(values[1]);
+	CHECK(values[2].value() == "view_value_1");
+
+	auto values_list = trans->multi_get({"view_key_2", "view_key_3"});
+	REQUIRE(2 == values_list.size());
+	CHECK(values_list[0].value() == "view_value_2");
+	CHECK(values_list[1].value() == "view_value_3");
+
+  }// End section : multi get
+
+}// End TestCase : ffdb_testcase_views
+
+
+TEST_CASE("ffdb_testcase_stream") {
+
+  constexpr int number_key = 3000;
+
+  auto init_trans = testing::ffdb.make_transaction();
+  for (int i = 0; i < number_key; ++i) {
+	init_trans->put(fmt::format("S_key_{:04}", i), fmt::format("S_value_{:04}", i));
+  }
+  init_trans->commit();
+
+  SECTION("forward stream") {
+	auto trans = testing::ffdb.make_transaction();
+	int batches = 0;
+	int counter = 0;
+
+	ffdb::stream_options opt;
+	opt.mode = FDBStreamingMode::FDB_STREAMING_MODE_SMALL;
+
+	auto total = trans->get_range_stream("S", "T", [&](const ffdb::range_view &batch) {
+	  ++batches;
+	  for (auto [key, value] : batch) {
+		REQUIRE(key == fmt::format("S_key_{:04}", counter));
+		++counter;
+	  }
+	}, opt);
+
+	CHECK(number_key == total);
+	CHECK(number_key == counter);
+	CHECK(batches > 1);
+
+  }// End section : forward stream
+
+  SECTION("reverse stream with limit") {
+	auto trans = testing::ffdb.make_transaction();
+	int counter = number_key - 1;
+
+	ffdb::stream_options opt;
+	opt.reverse = true;
+	opt.limit = 2500;
+
+	auto total = trans->get_range_stream("S", "T", [&](const ffdb::range_view &batch) {
+	  for (auto [key, value] : batch) {
+		REQUIRE(key == fmt::format("S_key_{:04}", counter));
+		--counter;
+	  }
+	}, opt);
+
+	CHECK(2500 == total);
+	CHECK(number_key - 2501 == counter);
+
+  }// End section : reverse stream with limit
+
+  auto clear_trans = testing::ffdb.make_transaction();
+  clear_trans->del_range("S", "T");
+  clear_trans->commit();
+
+}// End TestCase : ffdb_testcase_stream
+
+
+TEST_CASE("ffdb_testcase_string_view_and_bytes") {
+
+  SECTION("string_view") {
+	auto trans = testing::ffdb.make_transaction();
+	std::string buffer = "sv_key_1sv_value_1sv_key_2";
+	std::string_view key_1(buffer.data(), 8);
+	std::string_view value_1(buffer.data() + 8, 10);
+	std::string_view key_2(buffer.data() + 18, 8);
+
+	trans->put(key_1, value_1);
+	trans->put(key_2, value_1);
+
+	auto kv = trans->get(key_1);
+	REQUIRE(kv);
+	CHECK(kv->key == "sv_key_1");
+	CHECK(kv->value == "sv_value_1");
+
+	CHECK(2 == trans->get_range(key_1, "sv_key_3").values.size());
+	trans->del_range(key_1, key_2);
+	CHECK_FALSE(trans->get(key_1));
+	trans->del(key_2);
+	CHECK_FALSE(trans->get(key_2));
+
+  }// End section : string_view
+
+  SECTION("bytes") {
+	auto trans = testing::ffdb.make_transaction();
+	const std::uint8_t key[] = {'b', 'y', 't', 'e', 0x00, 0xff, 0x01};
+	const std::uint8_t value[] = {0x00, 0x01, 0x02};
+
+	trans->put(key, sizeof(key), value, sizeof(value));
+
+	auto kv = trans->get_view(key, sizeof(key));
+	REQUIRE(kv);
+	CHECK(kv.value() == std::string_view("\x00\x01\x02", 3));
+
+	CHECK(1 == trans->get_range(key, 4, key, sizeof(key), ffdb::range_options{0, 0, true, true}).values.size());
+
+	trans->del(key, sizeof(key));
+	CHECK_FALSE(trans->get(key, sizeof(key)));
+
+	SECTION("counter") {
+	  ffdb::fdb_counter counter(key, sizeof(key));
+	  counter.add(*trans, 42);
+	  CHECK(42 == counter.value(*trans));
+	}// End section : counter
+
+  }// End section : bytes
+
+}// End TestCase : ffdb_testcase_string_view_and_bytes
+
+TEST_CASE("ffdb_testcase_transaction_pool") {
+
+  SECTION("transaction is reused and reset") {
+	// every transaction of the pool is used once without being committed
+	{
+	  std::vector<ffdb::pooled_transaction> transactions;
+	  for (int i = 0; i < 64; ++i) {
+		auto &trans = transactions.emplace_back(testing::ffdb.acquire_transaction());
+		trans->put("pooled_key", "not committed");
+	  }
+	}
+	auto trans = testing::ffdb.acquire_transaction();
+	// writes of the previous usage are discarded by the reset
+	CHECK_FALSE(trans->get("pooled_key"));
+
+	trans->put("pooled_key", "committed");
+	trans->commit();
+
+	auto check_trans = testing::ffdb.acquire_transaction();
+	CHECK(check_trans.get() != trans.get());
+	auto kv = check_trans->get("pooled_key");
+	REQUIRE(kv);
+	CHECK(kv->value == "committed");
+	check_trans->del("pooled_key");
+	check_trans->commit();
+
+  }// End section : transaction is reused and reset
+
+  SECTION("concurrent usage") {
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 8; ++t) {
+	  threads.emplace_back([t]() {
+		for (int i = 0; i < 100; ++i) {
+		  auto trans = testing::ffdb.acquire_transaction();
+		  trans->put(fmt::format("pooled_{}", t), fmt::format("{}", i));
+		  trans->commit();
+		}
+	  });
+	}
+	for (auto &thread : threads) {
+	  thread.join();
+	}
+	auto trans = testing::ffdb.acquire_transaction();
+	auto result = trans->get_range("pooled_", "pooled`");
+	REQUIRE(result.values.size() == 8);
+	for (const auto &kv : result.values) {
+	  CHECK(kv.value == "99");
+	}
+	trans->del_range("pooled_", "pooled`");
+	trans->commit();
+
+  }// End section : concurrent usage
+
+}// End TestCase : ffdb_testcase_transaction_pool
+
+TEST_CASE("ffdb_testcase_options") {
+
+  SECTION("read your writes disabled") {
+	auto trans = testing::ffdb.make_transaction();
+	trans->disable_read_your_writes();
+	trans->put("option_key", "value");
+	CHECK_FALSE(trans->get("option_key"));
+	trans->commit();
+
+	auto check_trans = testing::ffdb.make_transaction();
+	CHECK(check_trans->get("option_key"));
+	check_trans->del("option_key");
+	check_trans->commit();
+
+  }// End section : read your writes disabled
+
+  SECTION("retry limit") {
+	auto trans = testing::ffdb.make_transaction();
+	trans->set_retry_limit(1);
+	// not_committed (conflict)
+	constexpr fdb_error_t not_committed = 1020;
+	trans->on_error(not_committed);
+	CHECK_THROWS_AS(trans->on_error(not_committed), ffdb::fdb_exception);
+
+  }// End section : retry limit
+
+  SECTION("user version restart on retry") {
+	auto trans = testing::ffdb.make_transaction();
+	CHECK(trans->next_user_version() == 0);
+	CHECK(trans->next_user_version() == 1);
+	// not_committed (conflict)
+	constexpr fdb_error_t not_committed = 1020;
+	trans->on_error(not_committed);
+	CHECK(trans->next_user_version() == 0);
+
+  }// End section : user version restart on retry
+
+  SECTION("timeout") {
+	auto trans = testing::ffdb.make_transaction();
+	trans->set_timeout(std::chrono::milliseconds(1));
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	try {
+	  trans->get("option_key");
+	  FAIL("transaction should have timed out");
+	} catch (const ffdb::fdb_exception &e) {
+	  // transaction_timed_out
+	  CHECK(e.code() == 1031);
+	}
+
+  }// End section : timeout
+
+  SECTION("size limit") {
+	auto trans = testing::ffdb.make_transaction();
+	trans->set_size_limit(1000);
+	trans->put("option_key", std::string(2000, 'v'));
+	CHECK_THROWS_AS(trans->commit(), ffdb::fdb_exception);
+
+  }// End section : size limit
+
+  SECTION("priority, causal read risky, read ahead") {
+	auto trans = testing::ffdb.make_transaction();
+	trans->set_options(ffdb::transaction_options{
+		std::chrono::seconds(5), 10, std::chrono::milliseconds(500), std::nullopt,
+		false, true, true, ffdb::transaction_priority::batch, false});
+	trans->put("option_key", "value");
+	trans->commit();
+
+	auto check_trans = testing::ffdb.make_transaction();
+	check_trans->set_priority(ffdb::transaction_priority::system_immediate);
+	CHECK(check_trans->get("option_key"));
+	check_trans->del("option_key");
+	check_trans->commit();
+
+  }// End section : priority, causal read risky, read ahead
+
+  SECTION("database defaults are kept on reset") {
+	ffdb::transaction_options defaults;
+	defaults.read_your_writes_disable = true;
+	testing::ffdb.set_transaction_options(defaults);
+
+	auto trans = testing::ffdb.make_transaction();
+	trans->put("option_key", "value");
+	CHECK_FALSE(trans->get("option_key"));
+	trans->reset();
+	trans->put("option_key", "value");
+	CHECK_FALSE(trans->get("option_key"));
+
+	testing::ffdb.set_transaction_options({});
+	auto default_trans = testing::ffdb.make_transaction();
+	default_trans->put("option_key", "value");
+	CHECK(default_trans->get("option_key"));
+
+  }// End section : database defaults are kept on reset
+
+  SECTION("database defaults are applied again on retry") {
+	ffdb::transaction_options defaults;
+	defaults.read_your_writes_disable = true;
+	defaults.retry_limit = 1;
+	testing::ffdb.set_transaction_options(defaults);
+
+	auto trans = testing::ffdb.make_transaction();
+	// not_committed (conflict)
+	constexpr fdb_error_t not_committed = 1020;
+	trans->on_error(not_committed);
+	trans->put("option_key", "value");
+	CHECK_FALSE(trans->get("option_key"));
+	// the retry limit is kept by foundationdb
+	CHECK_THROWS_AS(trans->on_error(not_committed), ffdb::fdb_exception);
+
+	testing::ffdb.set_transaction_options({});
+
+  }// End section : database defaults are applied again on retry
+
+  SECTION("pooled transactions take the new database defaults") {
+	{
+	  auto pooled = testing::ffdb.acquire_transaction();
+	  ffdb::transaction_options defaults;
+	  defaults.read_your_writes_disable = true;
+	  testing::ffdb.set_transaction_options(defaults);
+	  // given back with the previous defaults: destroyed instead of pooled
+	}
+	auto trans = testing::ffdb.acquire_transaction();
+	trans->put("option_key", "value");
+	CHECK_FALSE(trans->get("option_key"));
+
+	testing::ffdb.set_transaction_options({});
+	trans.reset();
+	auto default_trans = testing::ffdb.acquire_transaction();
+	default_trans->put("option_key", "value");
+	CHECK(default_trans->get("option_key"));
+
+  }// End section : pooled transactions take the new database defaults
+
+}// End TestCase : ffdb_testcase_options
+
+TEST_CASE("ffdb_testcase_read_version_cache") {
+
+  SECTION("without cache") {
+	auto trans = testing::ffdb.make_read_transaction();
+	CHECK(trans->get_read_version().get() > 0);
+	CHECK_FALSE(trans->get("read_version_key"));
+
+  }// End section : without cache
+
+  SECTION("read transactions share the read version") {
+	testing::ffdb.enable_read_version_cache({std::chrono::milliseconds(4000), std::chrono::milliseconds(2000)});
+
+	auto trans = testing::ffdb.make_read_transaction();
+	auto other = testing::ffdb.make_read_transaction();
+	CHECK(trans->get_read_version().get() == other->get_read_version().get());
+	CHECK(trans->get_read_version().get() == testing::ffdb.read_version());
+
+	testing::ffdb.disable_read_version_cache();
+
+  }// End section : read transactions share the read version
+
+  SECTION("read version is refreshed") {
+	testing::ffdb.enable_read_version_cache({std::chrono::milliseconds(100), std::chrono::milliseconds(10)});
+
+	const std::int64_t first = testing::ffdb.read_version();
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	CHECK(testing::ffdb.read_version() > first);
+
+	testing::ffdb.disable_read_version_cache();
+
+  }// End section : read version is refreshed
+
+  SECTION("snapshot shared between transactions") {
+	{
+	  auto trans = testing::ffdb.make_transaction();
+	  trans->put("read_version_key", "before");
+	  trans->commit();
+	}
+	const std::int64_t snapshot = testing::ffdb.read_version();
+	{
+	  auto trans = testing::ffdb.make_transaction();
+	  trans->put("read_version_key", "after");
+	  trans->commit();
+	}
+
+	std::vector<std::thread> readers;
+	std::atomic<int> consistent_reads = 0;
+	for (int i = 0; i < 4; ++i) {
+	  readers.emplace_back([&consistent_reads, snapshot]() {
+		auto trans = testing::ffdb.make_transaction_at(snapshot);
+		auto kv = trans->get("read_version_key");
+		if (kv && kv->value == "before") {
+		  ++consistent_reads;
+		}
+	  });
+	}
+	for (auto &reader : readers) {
+	  reader.join();
+	}
+	CHECK(consistent_reads == 4);
+
+	auto trans = testing::ffdb.make_transaction();
+	auto kv = trans->get("read_version_key");
+	REQUIRE(kv);
+	CHECK(kv->value == "after");
+	trans->del("read_version_key");
+	trans->commit();
+
+  }// End section : snapshot shared between transactions
+
+  SECTION("staleness has to be lower than 5 seconds") {
+	CHECK_THROWS_AS(testing::ffdb.enable_read_version_cache({std::chrono::seconds(5)}), ffdb::fdb_exception);
+
+  }// End section : staleness has to be lower than 5 seconds
+
+}// End TestCase : ffdb_testcase_read_version_cache
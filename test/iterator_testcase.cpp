@@ -292,6 +292,21 @@ TEST_CASE("iterator_testcase", "[db_test]") {
 
   }// End section : iterate seek_for_prev
 
+  SECTION("seek_for_prev key ending with a null byte") {
+
+	auto opt = ffdb::it_options{"A", "F"};
+	auto it = testing::ffdb.make_iterator(std::move(opt));
+
+	it.seek_for_prev(std::string("B_key_1\0", 8));
+	REQUIRE(it.is_valid());
+	CHECK(it.key() == "B_key_1");
+
+	it.next();
+	REQUIRE(it.is_valid());
+	CHECK(it.key() == "A_key_4");
+
+  }// End section : seek_for_prev key ending with a null byte
+
   SECTION("iterator re-use") {
 
 	auto opt = ffdb::it_options{"A", "D"};
@@ -306,14 +321,14 @@ TEST_CASE("iterator_testcase", "[db_test]") {
 	CHECK(it.key() == "A_key_3");
 
 	// re-initialize by seeking something else
-	it.seek_last(); // A_key_4
-	it.next(); // A_key_3
-	it.next(); // A_key_2
+	it.seek_last(); // C_key_1
+	it.next(); // B_key_2
+	it.next(); // B_key_1
 
 	REQUIRE(it.is_valid());
 	auto& [key, value] = *it;
-	CHECK(key == "A_key_2");
-	CHECK(value == "A_value_2");
+	CHECK(key == "B_key_1");
+	CHECK(value == "B_value_1");
 
   }// End section : iterator re-use
 
@@ -332,10 +347,75 @@ TEST_CASE("iterator_testcase", "[db_test]") {
 	it.seek_for_prev("@");
 	CHECK_FALSE(it.is_valid());
 
+	it.seek_for_prev("");
+	CHECK_FALSE(it.is_valid());
+
+	// no prefix range for these keys
+	CHECK_THROWS_AS(it.seek(""), ffdb::fdb_exception);
+	CHECK_THROWS_AS(it.seek("\xff\xff"), ffdb::fdb_exception);
+
 	auto& [key_2, value_2] = *it;
 	CHECK(key_2.empty());
 	CHECK(value_2.empty());
 
   }// End section : iterator nothing found on seek
 
-}// End TestCase : iterator_testcase
\ No newline at end of file
+}// End TestCase : iterator_testcase
+
+TEST_CASE("iterator_paging_testcase", "[db_test]") {
+
+  constexpr int number_key = 2000;
+
+  auto init_trans = testing::ffdb.make_transaction();
+  for (int i = 0; i < number_key; ++i) {
+	init_trans->put(fmt::format("P_key_{:04}", i), fmt::format("P_value_{:04}", i));
+  }
+  init_trans->commit();
+
+  SECTION("forward iteration through multiple pages") {
+	auto it = testing::ffdb.make_iterator(ffdb::it_options{"P", "Q"});
+
+	int counter = 0;
+	for (it.seek_first(); it.is_valid(); ++it) {
+	  REQUIRE(it.key() == fmt::format("P_key_{:04}", counter));
+	  REQUIRE(it.value() == fmt::format("P_value_{:04}", counter));
+	  ++counter;
+	}
+	// last element is held by the iterator when it become invalid
+	CHECK(it.key() == fmt::format("P_key_{:04}", number_key - 1));
+	CHECK(number_key - 1 == counter);
+
+  }// End section : forward iteration through multiple pages
+
+  SECTION("backward iteration through multiple pages") {
+	auto it = testing::ffdb.make_iterator(ffdb::it_options{"P", "Q"});
+
+	int counter = number_key - 1;
+	for (it.seek_last(); it.is_valid(); ++it) {
+	  REQUIRE(it.key() == fmt::format("P_key_{:04}", counter));
+	  --counter;
+	}
+	CHECK(it.key() == "P_key_0000");
+	CHECK(0 == counter);
+
+  }// End section : backward iteration through multiple pages
+
+  SECTION("limit is respected across pages") {
+	auto opt = ffdb::it_options{"P", "Q"};
+	opt.limit = 1500;
+	auto it = testing::ffdb.make_iterator(std::move(opt));
+
+	int counter = 1;
+	for (it.seek_first(); it.is_valid(); ++it) {
+	  ++counter;
+	}
+	CHECK(it.key() == "P_key_1499");
+	CHECK(1500 == counter);
+
+  }// End section : limit is respected across pages
+
+  auto clear_trans = testing::ffdb.make_transaction();
+  clear_trans->del_range("P", "Q");
+  clear_trans->commit();
+
+}// End TestCase : iterator_paging_testcase
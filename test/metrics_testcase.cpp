@@ -0,0 +1,172 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+
+#include "../include/free_fdb/metrics.hh"
+
+#include "db_setup_test.hh"
+
+using ffdb::metrics::counter;
+using ffdb::metrics::histogram;
+using ffdb::metrics::operation;
+
+TEST_CASE("metrics_testcase_histogram") {
+
+  SECTION("buckets") {
+	for (std::uint64_t value : {0ull, 1ull, 7ull, 8ull, 9ull, 1000ull, 123456789ull, ~0ull}) {
+	  const std::size_t bucket = histogram::bucket_of(value);
+	  REQUIRE(bucket < histogram::bucket_count);
+	  CHECK(histogram::bucket_upper_bound(bucket) >= value);
+	  if (bucket > 0) {
+		CHECK(histogram::bucket_upper_bound(bucket - 1) < value);
+	  }
+	}
+
+  }// End section : buckets
+
+  SECTION("percentiles") {
+	histogram h;
+	CHECK(h.percentile(50) == std::chrono::nanoseconds(0));
+	for (int i = 1; i <= 1000; ++i) {
+	  h.record(std::chrono::microseconds(i));
+	}
+	CHECK(h.count() == 1000);
+	CHECK(h.mean() == std::chrono::nanoseconds(500500));
+	CHECK(h.max() == std::chrono::milliseconds(1));
+	CHECK(h.percentile(100) == std::chrono::milliseconds(1));
+
+	// relative error lower than 12.5%
+	CHECK(h.percentile(50) >= std::chrono::microseconds(500));
+	CHECK(h.percentile(50) <= std::chrono::microseconds(563));
+	CHECK(h.percentile(99) >= std::chrono::microseconds(990));
+
+	histogram other;
+	other.record(std::chrono::milliseconds(2));
+	other.merge(h);
+	CHECK(other.count() == 1001);
+	CHECK(other.max() == std::chrono::milliseconds(2));
+	other.subtract(h);
+	CHECK(other.count() == 1);
+	CHECK(other.percentile(50) >= std::chrono::milliseconds(2));
+
+	// the maximum of a difference is the one of the values recorded in between
+	histogram later = h;
+	later.record(std::chrono::microseconds(10));
+	later.subtract(h);
+	CHECK(later.max() >= std::chrono::microseconds(10));
+	CHECK(later.max() < std::chrono::microseconds(12));
+	CHECK(later.percentile(100) == later.max());
+
+  }// End section : percentiles
+
+}// End TestCase : metrics_testcase_histogram
+
+TEST_CASE("metrics_testcase_instrumentation", "[db_test]") {
+
+  SECTION("transaction and iterator operations are recorded") {
+	const auto before = ffdb::metrics::take_snapshot();
+	{
+	  auto trans = testing::ffdb.make_transaction();
+	  trans->put("METRICS/1", "value_1");
+	  trans->put("METRICS/2", "value_2");
+	  trans->commit();
+	}
+	{
+	  auto trans = testing::ffdb.make_transaction();
+	  CHECK(trans->get("METRICS/1"));
+	  CHECK(trans->get_range("METRICS/", "METRICS0").values.size() == 2);
+	  trans->on_error(1020);
+	}
+	auto it = testing::ffdb.make_iterator();
+	it.seek("METRICS/");
+	while (it.is_valid()) {
+	  it.next();
+	}
+	const auto delta = ffdb::metrics::take_snapshot().since(before);
+
+	CHECK(delta.latency(operation::commit).count() >= 1);
+	CHECK(delta.latency(operation::get).count() >= 1);
+	CHECK(delta.latency(operation::get_range).count() >= 1);
+	CHECK(delta.latency(operation::iterator_page).count() >= 1);
+	CHECK(delta.latency(operation::on_error).count() >= 1);
+	CHECK(delta.latency(operation::commit).percentile(50) > std::chrono::nanoseconds(0));
+
+	CHECK(delta.value(counter::bytes_written) >= 2 * (9 + 7));
+	CHECK(delta.value(counter::rows_scanned) >= 4);
+	CHECK(delta.value(counter::bytes_read) >= 3 * (9 + 7));
+	CHECK(delta.value(counter::conflicts) >= 1);
+	CHECK(delta.value(counter::retries) >= 1);
+
+	auto trans = testing::ffdb.make_transaction();
+	trans->del_range("METRICS/", "METRICS0");
+	trans->commit();
+
+  }// End section : transaction and iterator operations are recorded
+
+  SECTION("asynchronous result retrieved twice is recorded once") {
+	const auto before = ffdb::metrics::take_snapshot();
+	auto trans = testing::ffdb.make_transaction();
+	auto result = trans->get_async("METRICS/1");
+	CHECK_FALSE(result.get());
+	CHECK_FALSE(result.get());
+	CHECK(ffdb::metrics::take_snapshot().since(before).latency(operation::get).count() == 1);
+
+  }// End section : asynchronous result retrieved twice is recorded once
+
+  SECTION("disabled") {
+	ffdb::metrics::set_enabled(false);
+	const auto before = ffdb::metrics::take_snapshot();
+	{
+	  auto trans = testing::ffdb.make_transaction();
+	  trans->put("METRICS/1", "value_1");
+	}
+	CHECK(ffdb::metrics::take_snapshot().since(before).value(counter::bytes_written) == 0);
+	ffdb::metrics::set_enabled(true);
+	CHECK(ffdb::metrics::is_enabled());
+
+  }// End section : disabled
+
+  SECTION("exporter") {
+	std::atomic<int> exported = 0;
+	std::atomic<std::uint64_t> written = 0;
+	{
+	  auto handler = [&](const ffdb::metrics::snapshot &delta) {
+		++exported;
+		written += delta.value(counter::bytes_written);
+	  };
+	  ffdb::metrics::exporter exporter(handler, std::chrono::milliseconds(10));
+	  auto trans = testing::ffdb.make_transaction();
+	  trans->put("METRICS/1", "value_1");
+	  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+	CHECK(exported >= 2);
+	CHECK(written >= 16);
+
+  }// End section : exporter
+
+}// End TestCase : metrics_testcase_instrumentation
@@ -0,0 +1,94 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+
+#include "../include/free_fdb/parallel_scan.hh"
+#include "db_setup_test.hh"
+
+TEST_CASE("parallel_scan_testcase") {
+
+  constexpr int number_key = 5000;
+
+  auto init_trans = testing::ffdb.make_transaction();
+  for (int i = 0; i < number_key; ++i) {
+	init_trans->put(fmt::format("PS_key_{:04}", i), fmt::format("PS_value_{:04}", i));
+  }
+  init_trans->commit();
+
+  std::mutex mutex;
+  std::set<std::string> scanned;
+  auto sink = [&](const ffdb::range_view &batch) {
+	std::scoped_lock lock(mutex);
+	for (auto [key, value] : batch) {
+	  CHECK(scanned.emplace(key).second);
+	}
+  };
+
+  SECTION("scan on the shard boundaries read from the database") {
+	ffdb::parallel_scanner scanner(testing::ffdb, "PS_", "PS_\xff", ffdb::scan_options{4});
+
+	// read from \xff/keyServers/, empty if the range is in a single shard (as on a test cluster)
+	auto points = scanner.split_points();
+	CHECK(std::is_sorted(points.begin(), points.end()));
+	for (const auto &point : points) {
+	  CHECK(point > "PS_");
+	  CHECK(point < "PS_\xff");
+	}
+
+	CHECK(number_key == scanner.scan(sink));
+	CHECK(number_key == scanned.size());
+	CHECK(*scanned.begin() == "PS_key_0000");
+	CHECK(*scanned.rbegin() == fmt::format("PS_key_{:04}", number_key - 1));
+
+  }// End section : scan on the shard boundaries read from the database
+
+  SECTION("scan on provided split points") {
+	ffdb::scan_options opt{4};
+	opt.split_points = {"PS_key_3000", "PS_key_1000", "PS_key_2000", "out_of_range", "PS_key_4000"};
+	ffdb::parallel_scanner scanner(testing::ffdb, "PS_", "PS_\xff", opt);
+
+	CHECK(std::vector<std::string>{"PS_key_1000", "PS_key_2000", "PS_key_3000", "PS_key_4000"} == scanner.split_points());
+	CHECK(number_key == scanner.scan(sink));
+	CHECK(number_key == scanned.size());
+
+  }// End section : scan on provided split points
+
+  SECTION("sink error stop the scan") {
+	ffdb::scan_options opt{4};
+	opt.split_points = {"PS_key_1000", "PS_key_2000", "PS_key_3000", "PS_key_4000"};
+	ffdb::parallel_scanner scanner(testing::ffdb, "PS_", "PS_\xff", opt);
+
+	CHECK_THROWS_AS(scanner.scan([](const ffdb::range_view &) { throw std::runtime_error("sink error"); }), std::runtime_error);
+
+  }// End section : sink error stop the scan
+
+  auto clear_trans = testing::ffdb.make_transaction();
+  clear_trans->del_range("PS_", "PS_\xff");
+  clear_trans->commit();
+
+}// End TestCase : parallel_scan_testcase
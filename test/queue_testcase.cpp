@@ -0,0 +1,158 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "../include/free_fdb/queue.hh"
+
+#include "db_setup_test.hh"
+
+TEST_CASE("queue_testcase", "[db_test]") {
+
+  const ffdb::fdb_queue queue(ffdb::subspace("QUEUE/"));
+
+  SECTION("push and pop in order") {
+	auto push_trans = testing::ffdb.make_transaction();
+	auto versionstamp = push_trans->get_versionstamp();
+	queue.push(*push_trans, "item_1");
+	queue.push(*push_trans, "item_2");
+	queue.push(*push_trans, "item_3");
+	push_trans->commit();
+	std::string stamp = versionstamp.get();
+	REQUIRE(stamp.size() == 10);
+
+	auto push_trans_2 = testing::ffdb.make_transaction();
+	queue.push(*push_trans_2, "item_4");
+	push_trans_2->commit();
+
+	auto trans = testing::ffdb.make_transaction();
+	CHECK_FALSE(queue.empty(*trans));
+	CHECK(queue.pop(*trans, 0).empty());
+	CHECK(queue.claim(*trans, 0, 0).empty());
+
+	auto first = queue.pop(*trans);
+	REQUIRE(first.size() == 1);
+	CHECK(first[0].value == "item_1");
+	CHECK(first[0].id.user_version == 0);
+	CHECK(std::string(first[0].id.transaction_version.begin(), first[0].id.transaction_version.end()) == stamp);
+
+	auto next = queue.pop(*trans, 10);
+	REQUIRE(next.size() == 3);
+	CHECK(next[0].value == "item_2");
+	CHECK(next[1].value == "item_3");
+	CHECK(next[2].value == "item_4");
+	CHECK(next[0].id.user_version == 1);
+	CHECK(next[1].id.user_version == 2);
+	trans->commit();
+
+	auto check_trans = testing::ffdb.make_transaction();
+	CHECK(queue.empty(*check_trans));
+	CHECK(queue.pop(*check_trans).empty());
+
+  }// End section : push and pop in order
+
+  SECTION("concurrent producers don't conflict") {
+	ffdb::run_stats total{};
+	std::mutex stats_mutex;
+	std::vector<std::thread> producers;
+	for (int t = 0; t < 4; ++t) {
+	  producers.emplace_back([&, t]() {
+		for (int i = 0; i < 50; ++i) {
+		  ffdb::run_stats stats;
+		  testing::ffdb.run([&](ffdb::fdb_transaction &trans) {
+			queue.push(trans, fmt::format("{}_{}", t, i));
+		  }, &stats);
+		  std::lock_guard lock(stats_mutex);
+		  total.retries += stats.retries;
+		}
+	  });
+	}
+	for (auto &p : producers) {
+	  p.join();
+	}
+	CHECK(total.retries == 0);
+
+	// each producer items are dequeued in the order they were pushed
+	std::vector<int> last(4, -1);
+	std::size_t dequeued = 0;
+	testing::ffdb.run([&](ffdb::fdb_transaction &trans) {
+	  std::fill(last.begin(), last.end(), -1);
+	  dequeued = 0;
+	  for (auto &item : queue.pop(trans, 1000)) {
+		int producer = item.value[0] - '0';
+		int index = std::stoi(item.value.substr(2));
+		CHECK(index > last[producer]);
+		last[producer] = index;
+		++dequeued;
+	  }
+	});
+	CHECK(dequeued == 200);
+
+  }// End section : concurrent producers don't conflict
+
+  SECTION("claim in window") {
+	auto push_trans = testing::ffdb.make_transaction();
+	for (int i = 0; i < 20; ++i) {
+	  queue.push(*push_trans, fmt::format("claim_{:02}", i));
+	}
+	push_trans->commit();
+
+	std::set<std::string> claimed;
+	while (true) {
+	  auto trans = testing::ffdb.make_transaction();
+	  auto items = queue.claim(*trans, 3, 10);
+	  if (items.empty()) {
+		break;
+	  }
+	  CHECK(items.size() <= 3);
+	  for (std::size_t i = 1; i < items.size(); ++i) {
+		CHECK(items[i - 1].value < items[i].value);
+	  }
+	  for (auto &item : items) {
+		CHECK(claimed.insert(item.value).second);
+	  }
+	  trans->commit();
+	}
+	CHECK(claimed.size() == 20);
+
+	// the window is capped at the limit of a range read
+	auto push_trans_2 = testing::ffdb.make_transaction();
+	queue.push(*push_trans_2, "claim_last");
+	push_trans_2->commit();
+	auto trans = testing::ffdb.make_transaction();
+	auto items = queue.claim(*trans, 1, std::numeric_limits<std::size_t>::max());
+	REQUIRE(items.size() == 1);
+	CHECK(items[0].value == "claim_last");
+
+  }// End section : claim in window
+
+  auto clear_trans = testing::ffdb.make_transaction();
+  clear_trans->del_range(queue.space());
+  clear_trans->commit();
+
+}// End TestCase : queue_testcase
@@ -0,0 +1,140 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include "../include/free_fdb/read_cache.hh"
+
+#include "db_setup_test.hh"
+
+namespace {
+
+void put(std::string_view key, std::string_view value) {
+  auto trans = testing::ffdb.make_transaction();
+  trans->put(key, value);
+  trans->commit();
+}
+
+template<typename Predicate>
+bool wait_for(Predicate &&predicate) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!predicate()) {
+	if (std::chrono::steady_clock::now() > deadline) {
+	  return false;
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+}// namespace
+
+TEST_CASE("read_cache_testcase", "[db_test]") {
+
+  {
+	auto trans = testing::ffdb.make_transaction();
+	trans->del_range("READCACHE/", "READCACHE0");
+	trans->commit();
+  }
+
+  SECTION("read through") {
+	ffdb::read_cache cache(testing::ffdb);
+	put("READCACHE/flag", "on");
+
+	auto first = cache.get("READCACHE/flag");
+	REQUIRE(first.value);
+	CHECK(*first.value == "on");
+	CHECK(first.version > 0);
+
+	auto second = cache.get("READCACHE/flag");
+	REQUIRE(second.value);
+	CHECK(*second.value == "on");
+	CHECK(second.version == first.version);
+
+	CHECK_FALSE(cache.get("READCACHE/absent").value);
+	CHECK_FALSE(cache.get("READCACHE/absent").value);
+
+	auto stats = cache.stats();
+	CHECK(stats.misses == 2);
+	CHECK(stats.hits == 2);
+	CHECK(stats.size == 2);
+
+  }// End section : read through
+
+  SECTION("invalidated on modification") {
+	ffdb::read_cache cache(testing::ffdb);
+	put("READCACHE/flag", "on");
+	CHECK(*cache.get("READCACHE/flag").value == "on");
+
+	put("READCACHE/flag", "off");
+	CHECK(wait_for([&cache] { return cache.stats().invalidations == 1; }));
+	CHECK(*cache.get("READCACHE/flag").value == "off");
+	CHECK(cache.stats().misses == 2);
+
+	cache.invalidate("READCACHE/flag");
+	CHECK(cache.stats().size == 0);
+	CHECK(*cache.get("READCACHE/flag").value == "off");
+	CHECK(cache.stats().misses == 3);
+
+  }// End section : invalidated on modification
+
+  SECTION("minimum version") {
+	ffdb::read_cache cache(testing::ffdb);
+	put("READCACHE/flag", "on");
+
+	auto cached = cache.get("READCACHE/flag");
+	auto reread = cache.get("READCACHE/flag", cached.version + 1);
+	CHECK(reread.version > cached.version);
+	CHECK(cache.stats().stale == 1);
+	CHECK(cache.stats().misses == 2);
+
+  }// End section : minimum version
+
+  SECTION("bounded size and watch budget") {
+	ffdb::read_cache_options opt;
+	opt.capacity = 2;
+	opt.shards = 1;
+	opt.max_watches = 3;
+	ffdb::read_cache cache(testing::ffdb, opt);
+
+	CHECK_FALSE(cache.get("READCACHE/1").value);
+	CHECK_FALSE(cache.get("READCACHE/2").value);
+	CHECK_FALSE(cache.get("READCACHE/3").value);
+	auto stats = cache.stats();
+	CHECK(stats.size == 2);
+	CHECK(stats.evictions == 1);
+	CHECK(stats.uncached == 0);
+
+	opt.max_watches = 0;
+	ffdb::read_cache uncached(testing::ffdb, opt);
+	CHECK_FALSE(uncached.get("READCACHE/1").value);
+	CHECK(uncached.stats().uncached == 1);
+	CHECK(uncached.stats().size == 0);
+
+  }// End section : bounded size and watch budget
+
+}// End TestCase : read_cache_testcase
@@ -0,0 +1,139 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch2/catch.hpp>
+
+#include "../include/free_fdb/subspace.hh"
+
+#include "db_setup_test.hh"
+
+using namespace std::string_literals;
+
+TEST_CASE("subspace_testcase_keys") {
+
+  SECTION("strinc") {
+	CHECK(ffdb::strinc("a") == "b");
+	CHECK(ffdb::strinc("ab") == "ac");
+	CHECK(ffdb::strinc("a\xff") == "b");
+	CHECK(ffdb::strinc("a\xff\xff") == "b");
+	CHECK(ffdb::strinc("a\xfe\xff") == "a\xff");
+	CHECK_THROWS_AS(ffdb::strinc(""), ffdb::fdb_exception);
+	CHECK_THROWS_AS(ffdb::strinc("\xff\xff"), ffdb::fdb_exception);
+  }
+
+  SECTION("prefix and range") {
+	ffdb::subspace space("S\xff");
+	CHECK(space.key() == "S\xff");
+	CHECK(space.range().begin == "S\xff");
+	CHECK(space.range().end == "T");
+
+	ffdb::subspace root;
+	CHECK(root.range().begin.empty());
+	CHECK(root.range().end == "\xff");
+  }
+
+  SECTION("child keys") {
+	ffdb::subspace users("users/");
+	auto key = users.pack(42, "name");
+	CHECK(key == "users/" + ffdb::tuple::pack(42, "name"));
+	CHECK(users.contains(key));
+	CHECK_FALSE(users.contains("other/"));
+
+	auto [id, field] = users.unpack<int, std::string>(key);
+	CHECK(id == 42);
+	CHECK(field == "name");
+	CHECK_THROWS_AS(users.unpack<int>("other/"), ffdb::fdb_exception);
+
+	auto user_42 = users.sub(42);
+	CHECK(user_42.key() == "users/" + ffdb::tuple::pack(42));
+	CHECK(user_42.pack("name") == key);
+
+	std::string buffer;
+	user_42.pack_to(buffer, "name");
+	CHECK(buffer == key);
+
+	CHECK(ffdb::subspace::from_tuple("users").key() == ffdb::tuple::pack("users"));
+  }
+}
+
+TEST_CASE("subspace_testcase", "[db_test]") {
+
+  const ffdb::subspace space("SUB\xff");
+
+  auto init_trans = testing::ffdb.make_transaction();
+  init_trans->put("SUB", "before");
+  for (int i = 0; i < 10; ++i) {
+	init_trans->put(space.pack(i), fmt::format("value_{}", i));
+  }
+  init_trans->put("SUC", "after");
+  init_trans->commit();
+
+  SECTION("get range on subspace") {
+	auto trans = testing::ffdb.make_transaction();
+	auto result = trans->get_range(space);
+	REQUIRE(result.values.size() == 10);
+	for (int i = 0; i < 10; ++i) {
+	  CHECK(std::get<0>(space.unpack<int>(result.values[i].key)) == i);
+	  CHECK(result.values[i].value == fmt::format("value_{}", i));
+	}
+	CHECK(trans->get_range_view(space).size() == 10);
+  }
+
+  SECTION("iterator on subspace") {
+	auto it = testing::ffdb.make_iterator(space);
+	int counter = 1;
+	for (it.seek_first(); it.is_valid(); ++it) {
+	  ++counter;
+	}
+	CHECK(it.key() == space.pack(9));
+	CHECK(counter == 10);
+  }
+
+  SECTION("seek on key ending with 0xff") {
+	auto it = testing::ffdb.make_iterator();
+	it.seek("SUB\xff");
+	CHECK(it.key() == space.pack(0));
+	int counter = 1;
+	for (; it.is_valid(); ++it) {
+	  ++counter;
+	}
+	CHECK(it.key() == space.pack(9));
+	CHECK(counter == 10);
+  }
+
+  SECTION("delete range on subspace") {
+	auto trans = testing::ffdb.make_transaction();
+	trans->del_range(space);
+	trans->commit();
+
+	auto check_trans = testing::ffdb.make_transaction();
+	CHECK(check_trans->get_range(space).values.empty());
+	CHECK(check_trans->get("SUB"));
+	CHECK(check_trans->get("SUC"));
+  }
+
+  auto clear_trans = testing::ffdb.make_transaction();
+  clear_trans->del_range("SUB", "SUD");
+  clear_trans->commit();
+
+}// End TestCase : subspace_testcase
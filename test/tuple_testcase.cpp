@@ -0,0 +1,150 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch2/catch.hpp>
+
+#include "../include/free_fdb/tuple.hh"
+
+using namespace std::string_literals;
+namespace tuple = ffdb::tuple;
+
+TEST_CASE("tuple_testcase_encoding") {
+
+  SECTION("official bindings encoding") {
+	CHECK(tuple::pack(nullptr) == "\x00"s);
+	CHECK(tuple::pack(true) == "\x27"s);
+	CHECK(tuple::pack(false) == "\x26"s);
+	CHECK(tuple::pack("hello") == "\x02hello\x00"s);
+	CHECK(tuple::pack(tuple::bytes{"foo\x00" "bar"s}) == "\x01" "foo\x00\xff" "bar\x00"s);
+
+	CHECK(tuple::pack(0) == "\x14"s);
+	CHECK(tuple::pack(1) == "\x15\x01"s);
+	CHECK(tuple::pack(255) == "\x15\xff"s);
+	CHECK(tuple::pack(256) == "\x16\x01\x00"s);
+	CHECK(tuple::pack(-1) == "\x13\xfe"s);
+	CHECK(tuple::pack(-255) == "\x13\x00"s);
+	CHECK(tuple::pack(-256) == "\x12\xfe\xff"s);
+	CHECK(tuple::pack(std::numeric_limits<std::int64_t>::max()) == "\x1c\x7f\xff\xff\xff\xff\xff\xff\xff"s);
+	CHECK(tuple::pack(std::numeric_limits<std::int64_t>::min()) == "\x0c\x7f\xff\xff\xff\xff\xff\xff\xff"s);
+	CHECK(tuple::pack(std::numeric_limits<std::uint64_t>::max()) == "\x1c\xff\xff\xff\xff\xff\xff\xff\xff"s);
+
+	CHECK(tuple::pack(1.0f) == "\x20\xbf\x80\x00\x00"s);
+	CHECK(tuple::pack(-1.0) == "\x21\x40\x0f\xff\xff\xff\xff\xff\xff"s);
+
+	// (b"foo\x00bar", None, ())
+	CHECK(tuple::pack(std::make_tuple(tuple::bytes{"foo\x00" "bar"s}, nullptr, std::tuple<>{}))
+		  == "\x05\x01" "foo\x00\xff" "bar\x00\x00\xff\x05\x00\x00"s);
+  }
+
+  SECTION("ordering is kept") {
+	CHECK(tuple::pack(-256) < tuple::pack(-255));
+	CHECK(tuple::pack(-255) < tuple::pack(-1));
+	CHECK(tuple::pack(-1) < tuple::pack(0));
+	CHECK(tuple::pack(0) < tuple::pack(1));
+	CHECK(tuple::pack(255) < tuple::pack(256));
+	CHECK(tuple::pack(-2.5) < tuple::pack(-1.0));
+	CHECK(tuple::pack(-1.0) < tuple::pack(0.0));
+	CHECK(tuple::pack(0.0) < tuple::pack(1.5));
+	CHECK(tuple::pack("a", 2) < tuple::pack("a", 10));
+	CHECK(tuple::pack("a") < tuple::pack("a", 0));
+	CHECK(tuple::pack("a", 10) < tuple::pack("b"));
+  }
+
+  SECTION("packed size and caller buffer") {
+	auto expected = tuple::pack("user", 42, tuple::bytes{"\x00"s}, 3.14);
+	REQUIRE(tuple::packed_size("user", 42, tuple::bytes{"\x00"s}, 3.14) == expected.size());
+
+	char buffer[64];
+	char *end = tuple::pack_to(buffer, "user", 42, tuple::bytes{"\x00"s}, 3.14);
+	CHECK(std::string_view(buffer, end - buffer) == expected);
+
+	std::string key = "prefix";
+	key.reserve(64);
+	const auto *data = key.data();
+	tuple::pack_append(key, "user", 42, tuple::bytes{"\x00"s}, 3.14);
+	CHECK(key == "prefix" + expected);
+	CHECK(key.data() == data);
+  }
+
+  SECTION("incomplete versionstamp") {
+	auto key = tuple::pack_with_versionstamp("pre", "queue", tuple::versionstamp::incomplete(7));
+	auto encoded = tuple::pack("queue", tuple::versionstamp::incomplete(7));
+	REQUIRE(key.size() == 3 + encoded.size() + 4);
+	CHECK(key.substr(3, encoded.size()) == encoded);
+	// versionstamp position: prefix + string element + type code, little endian
+	CHECK(key.substr(key.size() - 4) == "\x0b\x00\x00\x00"s);
+
+	CHECK_THROWS_AS(tuple::pack_with_versionstamp("", "no versionstamp"), ffdb::fdb_exception);
+  }
+}
+
+TEST_CASE("tuple_testcase_decoding") {
+
+  SECTION("round trip") {
+	tuple::uuid id{{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}};
+	tuple::versionstamp stamp{{0, 0, 0, 0, 0, 0, 0, 1, 0, 2}, 3};
+	auto key = tuple::pack("str\x00"s, tuple::bytes{"raw"}, -42, 1ull << 40, true, 2.5f, -0.125, id, stamp, nullptr);
+
+	auto [s, b, i, u, boolean, f, d, uid, vs, null] =
+		tuple::unpack<std::string, std::string, int, std::uint64_t, bool, float, double, tuple::uuid, tuple::versionstamp, std::nullptr_t>(key);
+	CHECK(s == "str\x00"s);
+	CHECK(b == "raw");
+	CHECK(i == -42);
+	CHECK(u == 1ull << 40);
+	CHECK(boolean);
+	CHECK(f == 2.5f);
+	CHECK(d == -0.125);
+	CHECK(uid == id);
+	CHECK(vs == stamp);
+	CHECK(vs.is_complete());
+	CHECK(null == nullptr);
+  }
+
+  SECTION("integer limits") {
+	auto min = std::numeric_limits<std::int64_t>::min();
+	auto max = std::numeric_limits<std::int64_t>::max();
+	CHECK(std::get<0>(tuple::unpack<std::int64_t>(tuple::pack(min))) == min);
+	CHECK(std::get<0>(tuple::unpack<std::int64_t>(tuple::pack(max))) == max);
+	CHECK(std::get<0>(tuple::unpack<std::int8_t>(tuple::pack(-128))) == -128);
+	CHECK_THROWS_AS(tuple::unpack<std::int8_t>(tuple::pack(128)), ffdb::fdb_exception);
+	CHECK_THROWS_AS(tuple::unpack<std::uint32_t>(tuple::pack(-1)), ffdb::fdb_exception);
+  }
+
+  SECTION("nested tuple and optional") {
+	using nested = std::tuple<std::string, std::optional<int>, std::tuple<>>;
+	auto key = tuple::pack(std::make_tuple("foo", std::optional<int>{}, std::tuple<>{}), std::optional<int>(5));
+
+	auto [n, o] = tuple::unpack<nested, std::optional<int>>(key);
+	CHECK(std::get<0>(n) == "foo");
+	CHECK_FALSE(std::get<1>(n));
+	REQUIRE(o);
+	CHECK(*o == 5);
+  }
+
+  SECTION("invalid data") {
+	CHECK_THROWS_AS(tuple::unpack<int>(tuple::pack("string")), ffdb::fdb_exception);
+	CHECK_THROWS_AS(tuple::unpack<int>(tuple::pack(1, 2)), ffdb::fdb_exception);
+	CHECK_THROWS_AS((tuple::unpack<int, int>(tuple::pack(1))), ffdb::fdb_exception);
+	CHECK_THROWS_AS(tuple::unpack<std::string>("\x02unterminated"s), ffdb::fdb_exception);
+  }
+}
@@ -0,0 +1,158 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../include/free_fdb/watch.hh"
+
+#include "db_setup_test.hh"
+
+namespace {
+
+void put(std::string_view key, std::string_view value) {
+  auto trans = testing::ffdb.make_transaction();
+  trans->put(key, value);
+  trans->commit();
+}
+
+template<typename Predicate>
+bool wait_for(Predicate &&predicate) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!predicate()) {
+	if (std::chrono::steady_clock::now() > deadline) {
+	  return false;
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+}// namespace
+
+TEST_CASE("watch_testcase", "[db_test]") {
+
+  put("WATCH/key", "0");
+
+  SECTION("notified on each modification") {
+	ffdb::watcher watcher(testing::ffdb);
+	std::atomic<int> notified = 0;
+	auto handle = watcher.watch("WATCH/key", [&notified](const std::string &key) {
+	  CHECK(key == "WATCH/key");
+	  ++notified;
+	});
+	REQUIRE(wait_for([&handle] { return handle.is_armed(); }));
+
+	put("WATCH/key", "1");
+	CHECK(wait_for([&notified] { return notified == 1; }));
+
+	// re-armed before the callback is called
+	CHECK(handle.is_armed());
+	put("WATCH/key", "2");
+	CHECK(wait_for([&notified] { return notified == 2; }));
+
+  }// End section : notified on each modification
+
+  SECTION("cancelled watch is not notified") {
+	ffdb::watcher watcher(testing::ffdb);
+	std::atomic<int> notified = 0;
+	auto handle = watcher.watch("WATCH/key", [&notified](const std::string &) { ++notified; });
+	REQUIRE(wait_for([&handle] { return handle.is_armed(); }));
+	CHECK(watcher.size() == 1);
+
+	handle.cancel();
+	CHECK_FALSE(handle.is_armed());
+	CHECK(watcher.size() == 0);
+
+	put("WATCH/key", "1");
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	CHECK(notified == 0);
+
+  }// End section : cancelled watch is not notified
+
+  SECTION("too many watches") {
+	ffdb::watcher_options opt;
+	opt.max_watches = 2;
+	ffdb::watcher watcher(testing::ffdb, opt);
+
+	auto first = watcher.watch("WATCH/key", [](const std::string &) {});
+	auto second = watcher.watch("WATCH/other", [](const std::string &) {});
+	try {
+	  auto third = watcher.watch("WATCH/third", [](const std::string &) {});
+	  FAIL("watch limit should have been reached");
+	} catch (const ffdb::fdb_exception &e) {
+	  CHECK(e.code() == ffdb::too_many_watches);
+	}
+
+	// the handle release the watch
+	{ auto moved = std::move(first); }
+	CHECK(watcher.size() == 1);
+	auto third = watcher.watch("WATCH/third", [](const std::string &) {});
+	CHECK(watcher.size() == 2);
+
+  }// End section : too many watches
+
+  SECTION("many watches armed by batches") {
+	ffdb::watcher_options opt;
+	opt.max_batch = 100;
+	ffdb::watcher watcher(testing::ffdb, opt);
+
+	std::atomic<int> notified = 0;
+	std::vector<ffdb::watch_handle> handles;
+	for (int i = 0; i < 250; ++i) {
+	  handles.emplace_back(watcher.watch(fmt::format("WATCH/many/{}", i), [&notified](const std::string &) { ++notified; }));
+	}
+	REQUIRE(wait_for([&handles] {
+	  return std::all_of(handles.begin(), handles.end(), [](const auto &handle) { return handle.is_armed(); });
+	}));
+
+	auto trans = testing::ffdb.make_transaction();
+	for (int i = 0; i < 250; ++i) {
+	  trans->put(fmt::format("WATCH/many/{}", i), "modified");
+	}
+	trans->commit();
+	CHECK(wait_for([&notified] { return notified == 250; }));
+
+	auto clear = testing::ffdb.make_transaction();
+	clear->del_range("WATCH/many/", "WATCH/many0");
+	clear->commit();
+
+  }// End section : many watches armed by batches
+
+  SECTION("free_fdb watch") {
+	std::atomic<int> notified = 0;
+	auto handle = testing::ffdb.watch("WATCH/key", [&notified](const std::string &) { ++notified; });
+	REQUIRE(wait_for([&handle] { return handle.is_armed(); }));
+
+	put("WATCH/key", "1");
+	CHECK(wait_for([&notified] { return notified == 1; }));
+
+  }// End section : free_fdb watch
+
+}// End TestCase : watch_testcase
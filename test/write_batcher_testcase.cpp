@@ -0,0 +1,117 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "../include/free_fdb/write_batcher.hh"
+
+#include "db_setup_test.hh"
+
+TEST_CASE("write_batcher_testcase", "[db_test]") {
+
+  SECTION("puts from multiple threads") {
+	constexpr int number_thread = 8;
+	constexpr int number_put = 1000;
+	{
+	  ffdb::batcher_options opt;
+	  opt.max_batch_bytes = 16 * 1024;
+	  ffdb::write_batcher batcher(testing::ffdb, opt);
+
+	  std::vector<std::thread> threads;
+	  for (int t = 0; t < number_thread; ++t) {
+		threads.emplace_back([&batcher, t]() {
+		  std::vector<std::future<void>> results;
+		  for (int i = 0; i < number_put; ++i) {
+			results.emplace_back(batcher.put(fmt::format("WB_{}_{:04}", t, i), fmt::format("value_{}", i)));
+		  }
+		  for (auto &result : results) {
+			result.get();
+		  }
+		});
+	  }
+	  for (auto &t : threads) {
+		t.join();
+	  }
+	}
+
+	auto trans = testing::ffdb.make_transaction();
+	auto result = trans->get_range("WB_", "WB`");
+	CHECK(result.values.size() == number_thread * number_put);
+
+	auto kv = trans->get("WB_3_0042");
+	REQUIRE(kv);
+	CHECK(kv->value == "value_42");
+
+  }// End section : puts from multiple threads
+
+  SECTION("mixed operations") {
+	ffdb::write_batcher batcher(testing::ffdb);
+
+	std::int64_t one = 1;
+	std::vector<std::future<void>> results;
+	for (int i = 0; i < 100; ++i) {
+	  results.emplace_back(batcher.atomic_op(
+		  "WB_counter", std::string_view(reinterpret_cast<const char *>(&one), sizeof(one)),
+		  FDBMutationType::FDB_MUTATION_TYPE_ADD));
+	}
+	results.emplace_back(batcher.put("WB_to_delete", "value"));
+	for (auto &result : results) {
+	  result.get();
+	}
+	batcher.del("WB_to_delete").get();
+	batcher.put("WB_range_1", "value").get();
+	batcher.del_range("WB_range", "WB_rangf").get();
+
+	auto trans = testing::ffdb.make_transaction();
+	CHECK(ffdb::fdb_counter("WB_counter").value(*trans) == 100);
+	CHECK_FALSE(trans->get("WB_to_delete"));
+	CHECK_FALSE(trans->get("WB_range_1"));
+
+  }// End section : mixed operations
+
+  SECTION("failed batch complete futures with the error") {
+	ffdb::write_batcher batcher(testing::ffdb);
+
+	// keys are limited to 10kB
+	auto result = batcher.put(std::string(20000, 'K'), "value");
+	CHECK_THROWS_AS(result.get(), ffdb::fdb_exception);
+
+  }// End section : failed batch complete futures with the error
+
+  SECTION("invalid options") {
+	ffdb::batcher_options opt;
+	opt.max_batch_bytes = 10 * 1024 * 1024;
+	CHECK_THROWS_AS(ffdb::write_batcher(testing::ffdb, opt), ffdb::fdb_exception);
+	opt.max_batch_bytes = 0;
+	CHECK_THROWS_AS(ffdb::write_batcher(testing::ffdb, opt), ffdb::fdb_exception);
+
+  }// End section : invalid options
+
+  auto clear_trans = testing::ffdb.make_transaction();
+  clear_trans->del_range("WB_", "WB`");
+  clear_trans->commit();
+
+}// End TestCase : write_batcher_testcase
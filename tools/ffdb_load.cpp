@@ -0,0 +1,117 @@
+// MIT License
+//
+// Copyright (c) 2021 Quentin Balland
+// Repository : https://github.com/FreeYourSoul/free_fdb
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+//         of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+//         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//         copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+//         copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../include/free_fdb/bulk_loader.hh"
+
+namespace {
+
+void usage() {
+  std::cerr << "usage: ffdb_load <cluster_file> <input_file> [options]\n"
+			   "  --concurrency <n>       number of loading threads (default: hardware concurrency)\n"
+			   "  --partitions <n>        number of partitions of the input (default: 4 per thread)\n"
+			   "  --batch-bytes <n>       estimated size of the transactions, overhead included (default: 2MB)\n"
+			   "  --fixed <key> <value>   input made of fixed size records instead of length-prefixed ones (key > 0)\n"
+			   "  --checkpoint <prefix>   store the progression under this prefix and resume from it\n"
+			   "  --clear-checkpoint      remove the checkpoint once the input is fully loaded\n";
+}
+
+std::size_t to_size(std::string_view arg) {
+  return std::stoull(std::string(arg));
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+	usage();
+	return EXIT_FAILURE;
+  }
+  const std::string cluster_file = argv[1];
+  const std::string input_file = argv[2];
+
+  ffdb::load_options opt;
+  bool clear_checkpoint = false;
+  try {
+	for (int i = 3; i < argc; ++i) {
+	  std::string_view arg = argv[i];
+	  auto next = [&]() -> std::string_view {
+		if (i + 1 >= argc) {
+		  throw std::invalid_argument(fmt::format("missing value for {}", arg));
+		}
+		return argv[++i];
+	  };
+	  if (arg == "--concurrency") {
+		opt.concurrency = static_cast<unsigned>(to_size(next()));
+	  } else if (arg == "--partitions") {
+		opt.partitions = to_size(next());
+	  } else if (arg == "--batch-bytes") {
+		opt.max_batch_bytes = to_size(next());
+	  } else if (arg == "--fixed") {
+		opt.fixed_key_size = to_size(next());
+		opt.fixed_value_size = to_size(next());
+		if (opt.fixed_key_size == 0) {
+		  throw std::invalid_argument("--fixed requires a key size greater than 0");
+		}
+	  } else if (arg == "--checkpoint") {
+		opt.checkpoint = ffdb::subspace(next());
+	  } else if (arg == "--clear-checkpoint") {
+		clear_checkpoint = true;
+	  } else {
+		throw std::invalid_argument(fmt::format("unknown option {}", arg));
+	  }
+	}
+  } catch (const std::exception &e) {
+	std::cerr << "ffdb_load: " << e.what() << "\n";
+	usage();
+	return EXIT_FAILURE;
+  }
+
+  try {
+	ffdb::free_fdb db(cluster_file);
+	ffdb::bulk_loader loader(db, input_file, opt);
+
+	const auto start = std::chrono::steady_clock::now();
+	auto stats = loader.load();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (clear_checkpoint) {
+	  loader.clear_checkpoint();
+	}
+	fmt::print("loaded {} records ({} bytes) in {:.2f}s: {} transactions, {} retries, {}/{} partitions resumed\n",
+			   stats.records, stats.bytes, elapsed.count(), stats.transactions, stats.retries,
+			   stats.resumed_partitions, loader.partitions());
+	fmt::print("throughput: {:.0f} records/s, {:.2f} MB/s\n",
+			   stats.records / elapsed.count(), stats.bytes / elapsed.count() / (1024 * 1024));
+  } catch (const std::exception &e) {
+	std::cerr << "ffdb_load: " << e.what() << "\n";
+	return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}